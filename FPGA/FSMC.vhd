@@ -1,224 +1,390 @@
--------------------------------------------------------------------------------
--- file: FSMC.vhd
--- author: Rene Herthel <rene.herthel@haw-hamburg.de>
--- author: Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
--------------------------------------------------------------------------------
-library IEEE;
-use IEEE.STD_LOGIC_1164.ALL;
-use IEEE.STD_LOGIC_UNSIGNED.ALL;
-
-
--------------------------------------------------------------------------------
--- entity
--------------------------------------------------------------------------------
-entity FSMC is
-	port(
-		CLK_SYN		: in std_logic;
-		CLK_PE		: in std_logic;
-		NWE			: in std_logic;
-		NE			: in std_logic;
-		NOE			: in std_logic;
-		RESET_N		: in std_logic;
-		DATA		: inout std_logic_vector(15 downto 0);
-		RDY			: out std_logic
-	);
-end FSMC;
-
-
-architecture FSMC_ARCH of FSMC is
-
-
--------------------------------------------------------------------------------
--- component definition
--------------------------------------------------------------------------------
-component EQ_PE is
-	port(
-		CLK_PE		: in std_logic;
-		RESET_N		: in std_logic;
-		START		: in std_logic;
-		Y			: in std_logic_vector(15 downto 0);
-		RDY			: out std_logic;
-		W			: out std_logic_vector(15 downto 0)
-	);
-end component;
-
-
--------------------------------------------------------------------------------
--- signals
--------------------------------------------------------------------------------
-signal EN		: std_logic;
-signal W		: std_logic_vector(15 downto 0);
-signal Y		: std_logic_vector(15 downto 0);
-signal TRISTATE	: std_logic;
-signal START	: std_logic;
-
-signal NWE_Q1	: std_logic;
-signal NWE_Q2	: std_logic;
-signal NWE_Q3	: std_logic;
-signal NWE_AND1	: std_logic;
-signal NWE_AND2	: std_logic;
-signal NWE_Q4	: std_logic;
-
-signal NE_Q1	: std_logic;
-signal NE_Q2	: std_logic;
-
-signal NOE_Q1	: std_logic;
-signal NOE_Q2	: std_logic;
-
-signal DATA_Q1	: std_logic_vector(15 downto 0);
-signal DATA_Q2	: std_logic_vector(15 downto 0);
-
-signal W_CHECK	: std_logic_vector(15 downto 0);
-signal Y_CHECK	: std_logic_vector(15 downto 0);
-
-
-begin
-
--------------------------------------------------------------------------------
--- P_NWE
--------------------------------------------------------------------------------
-P_NWE: process(CLK_SYN, RESET_N)
-begin
-	if (RESET_N = '0') then
-		NWE_Q1 <= '0' after 1 ns;
-		EN <= '0' after 1 ns;
-	elsif (CLK_SYN = '1' and CLK_SYN'event) then
-		NWE_Q1 <= NWE after 1 ns;  -- IOB
-		EN <= NWE_AND2 after 1 ns; -- Pulse-Stretcher EN
-	end if;
-end process;
-
-
--------------------------------------------------------------------------------
--- Puls-Shorter
--------------------------------------------------------------------------------
-P_Shorter: process(CLK_SYN, RESET_N)
-begin
-	if (RESET_N = '0') then
-		NWE_Q2 <= '0' after 1 ns;
-		NWE_Q3 <= '0' after 1 ns;
-	elsif (CLK_SYN = '1' and CLK_SYN'event) then
-		NWE_Q2 <= NWE_Q1 after 1 ns;
-		NWE_Q3 <= NWE_Q2 after 1 ns;
-	end if;
-end process;
-
-
-NWE_AND1 <= NWE_Q3 and not NWE_Q2 after 1 ns;
-
-
--------------------------------------------------------------------------------
--- Puls-Stretcher
--------------------------------------------------------------------------------
-P_Stretcher1: process(EN, START)
-begin
-	if (START = '1') then
-		NWE_Q4 <= '0' after 1 ns;
-	elsif (EN = '1' and EN'event) then
-		NWE_Q4 <= '1' after 1 ns;
-	end if;
-end process;
-
-
-P_Stretcher2: process(CLK_PE, RESET_N)
-begin
-	if (RESET_N = '0') then
-		START <= '0' after 1 ns;
-	elsif (CLK_PE = '1' and CLK_PE'event) then
-		START <= NWE_Q4 after 1 ns;
-	end if;
-end process;
-
-
--------------------------------------------------------------------------------
--- P_NE
--------------------------------------------------------------------------------
-P_NE: process(CLK_SYN, RESET_N)
-begin
-	if (RESET_N = '0') then
-		NE_Q1 <= '0' after 1 ns;
-		NE_Q2 <= '0' after 1 ns;
-	elsif (CLK_SYN = '1' and CLK_SYN'event) then
-		NE_Q1 <= NE after 1 ns; -- IOB
-		NE_Q2 <= NE_Q1 after 1 ns;
-	end if;
-end process;
-
-
-NWE_AND2 <= NWE_AND1 and not NE_Q2 after 1 ns;
-
-
--------------------------------------------------------------------------------
--- P_NOE
--------------------------------------------------------------------------------
-P_NOE: process(CLK_SYN, RESET_N)
-begin
-	if (RESET_N = '0') then
-		NOE_Q1 <= '0' after 1 ns;
-		NOE_Q2 <= '0' after 1 ns;
-	elsif (CLK_SYN = '1' and CLK_SYN'event) then
-		NOE_Q1 <= NOE after 1 ns; --IOB
-		NOE_Q2 <= NOE_Q1 after 1 ns;
-	end if;
-end process;
-
-
-TRISTATE <= NE_Q2 or NOE_Q2 after 1 ns;
-
-
--------------------------------------------------------------------------------
--- P_DATA
--------------------------------------------------------------------------------
-P_DATA: process(TRISTATE, W_CHECK)
-begin
-	if (TRISTATE = '1') then
-		DATA <= (others => 'Z');
-	else
-     	DATA <= W_CHECK;
-	end if;
-end process;
-
-P_DATA_Q: process(CLK_SYN, RESET_N)
-begin
-	if (RESET_N = '0') then
-		DATA_Q1 <= (others => '0') after 1 ns;
-		DATA_Q2 <= (others => '0') after 1 ns;
-		Y <= (others => '0') after 1 ns;
-	elsif (CLK_SYN = '1' and CLK_SYN'event) then
-		DATA_Q1 <= DATA after 1 ns; -- IOB
-		DATA_Q2 <= DATA_Q1 after 1 ns;
-		if (EN = '1') then
-			Y <= DATA_Q2 after 1 ns;
-		end if;
-	end if;
-end process;
-
--------------------------------------------------------------------------------
--- 2's Complement
--------------------------------------------------------------------------------
-P_CMPLMNT: process(W, Y)
-begin
-	if (Y(15) = '1') then
-		Y_CHECK <= not(Y) + 1;
-		W_CHECK <= not(W) + 1;
-	else
-		Y_CHECK <= Y;
-		W_CHECK <= W;
-	end if;
-end process;
-
--------------------------------------------------------------------------------
--- EQ_PE instantiation
--------------------------------------------------------------------------------
-EQ_PE_C : EQ_PE
-	port map (
-		CLK_PE	=> CLK_PE,
-		RESET_N	=> RESET_N,
-		START	=> START,
-		Y		=> Y_CHECK,
-		RDY		=> RDY,
-		W		=> W
-	);
-
-
-end FSMC_ARCH;
+-------------------------------------------------------------------------------
+-- file: FSMC.vhd
+-- author: Rene Herthel <rene.herthel@haw-hamburg.de>
+-- author: Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+-------------------------------------------------------------------------------
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.STD_LOGIC_UNSIGNED.ALL;
+
+
+-------------------------------------------------------------------------------
+-- entity
+-------------------------------------------------------------------------------
+entity FSMC is
+	generic(
+		SYNC_MODE	: boolean := false;	-- synchronous burst interface (FSMC_CLK)
+		LATENCY		: natural := 2;		-- FSMC_CLK cycles before first data (DATLAT + 2)
+		FIFO_DEPTH	: natural := 16		-- words per burst (BURST_LEN in fsmc.c)
+	);
+	port(
+		CLK_SYN		: in std_logic;
+		CLK_PE		: in std_logic;
+		CLK_FSMC	: in std_logic;
+		NWE			: in std_logic;
+		NE			: in std_logic;
+		NOE			: in std_logic;
+		RESET_N		: in std_logic;
+		DATA		: inout std_logic_vector(15 downto 0);
+		RDY			: out std_logic
+	);
+end FSMC;
+
+
+architecture FSMC_ARCH of FSMC is
+
+
+-------------------------------------------------------------------------------
+-- component definition
+-------------------------------------------------------------------------------
+component EQ_PE is
+	port(
+		CLK_PE		: in std_logic;
+		RESET_N		: in std_logic;
+		START		: in std_logic;
+		Y			: in std_logic_vector(15 downto 0);
+		RDY			: out std_logic;
+		W			: out std_logic_vector(15 downto 0)
+	);
+end component;
+
+
+-------------------------------------------------------------------------------
+-- signals
+-------------------------------------------------------------------------------
+signal EN		: std_logic;
+signal W		: std_logic_vector(15 downto 0);
+signal Y		: std_logic_vector(15 downto 0);
+signal TRISTATE	: std_logic;
+signal START	: std_logic;
+
+signal NWE_Q1	: std_logic;
+signal NWE_Q2	: std_logic;
+signal NWE_Q3	: std_logic;
+signal NWE_AND1	: std_logic;
+signal NWE_AND2	: std_logic;
+signal NWE_Q4	: std_logic;
+
+signal NE_Q1	: std_logic;
+signal NE_Q2	: std_logic;
+
+signal NOE_Q1	: std_logic;
+signal NOE_Q2	: std_logic;
+
+signal DATA_Q1	: std_logic_vector(15 downto 0);
+signal DATA_Q2	: std_logic_vector(15 downto 0);
+
+signal W_CHECK	: std_logic_vector(15 downto 0);
+signal Y_CHECK	: std_logic_vector(15 downto 0);
+
+signal EN_PE	: std_logic;
+signal Y_PE		: std_logic_vector(15 downto 0);
+signal RDY_PE	: std_logic;
+signal DATA_OUT	: std_logic_vector(15 downto 0);
+
+----------------------------- SYNC_MODE -----------------------------
+type FIFO_TYPE is array (0 to FIFO_DEPTH - 1) of std_logic_vector(15 downto 0);
+type PE_STATE_TYPE is (PE_IDLE, PE_START, PE_DONE);
+
+signal IN_FIFO		: FIFO_TYPE;
+signal OUT_FIFO		: FIFO_TYPE;
+signal IN_WR		: integer range 0 to FIFO_DEPTH - 1;
+signal IN_RD		: integer range 0 to FIFO_DEPTH - 1;
+signal IN_CNT		: integer range 0 to FIFO_DEPTH;
+signal OUT_WR		: integer range 0 to FIFO_DEPTH - 1;
+signal OUT_RD		: integer range 0 to FIFO_DEPTH - 1;
+signal OUT_CNT		: integer range 0 to FIFO_DEPTH;
+
+signal CLK_FSMC_Q1	: std_logic;
+signal CLK_FSMC_Q2	: std_logic;
+signal CLK_FSMC_Q3	: std_logic;
+signal FSMC_EDGE	: std_logic;
+signal LAT_CNT		: integer range 0 to LATENCY;
+signal BEAT			: std_logic;
+
+signal PE_STATE		: PE_STATE_TYPE;
+signal EN_SYNC		: std_logic;
+signal Y_SYNC		: std_logic_vector(15 downto 0);
+signal RDY_Q1		: std_logic;
+signal RDY_Q2		: std_logic;
+signal WAIT_N		: std_logic;
+
+
+begin
+
+-------------------------------------------------------------------------------
+-- P_NWE
+-------------------------------------------------------------------------------
+P_NWE: process(CLK_SYN, RESET_N)
+begin
+	if (RESET_N = '0') then
+		NWE_Q1 <= '0' after 1 ns;
+		EN <= '0' after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		NWE_Q1 <= NWE after 1 ns;  -- IOB
+		EN <= NWE_AND2 after 1 ns; -- Pulse-Stretcher EN
+	end if;
+end process;
+
+
+-------------------------------------------------------------------------------
+-- Puls-Shorter
+-------------------------------------------------------------------------------
+P_Shorter: process(CLK_SYN, RESET_N)
+begin
+	if (RESET_N = '0') then
+		NWE_Q2 <= '0' after 1 ns;
+		NWE_Q3 <= '0' after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		NWE_Q2 <= NWE_Q1 after 1 ns;
+		NWE_Q3 <= NWE_Q2 after 1 ns;
+	end if;
+end process;
+
+
+NWE_AND1 <= NWE_Q3 and not NWE_Q2 after 1 ns;
+
+
+-------------------------------------------------------------------------------
+-- Puls-Stretcher
+-------------------------------------------------------------------------------
+P_Stretcher1: process(EN_PE, START)
+begin
+	if (START = '1') then
+		NWE_Q4 <= '0' after 1 ns;
+	elsif (EN_PE = '1' and EN_PE'event) then
+		NWE_Q4 <= '1' after 1 ns;
+	end if;
+end process;
+
+
+P_Stretcher2: process(CLK_PE, RESET_N)
+begin
+	if (RESET_N = '0') then
+		START <= '0' after 1 ns;
+	elsif (CLK_PE = '1' and CLK_PE'event) then
+		START <= NWE_Q4 after 1 ns;
+	end if;
+end process;
+
+
+-------------------------------------------------------------------------------
+-- P_NE
+-------------------------------------------------------------------------------
+P_NE: process(CLK_SYN, RESET_N)
+begin
+	if (RESET_N = '0') then
+		NE_Q1 <= '0' after 1 ns;
+		NE_Q2 <= '0' after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		NE_Q1 <= NE after 1 ns; -- IOB
+		NE_Q2 <= NE_Q1 after 1 ns;
+	end if;
+end process;
+
+
+NWE_AND2 <= NWE_AND1 and not NE_Q2 after 1 ns;
+
+
+-------------------------------------------------------------------------------
+-- P_NOE
+-------------------------------------------------------------------------------
+P_NOE: process(CLK_SYN, RESET_N)
+begin
+	if (RESET_N = '0') then
+		NOE_Q1 <= '0' after 1 ns;
+		NOE_Q2 <= '0' after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		NOE_Q1 <= NOE after 1 ns; --IOB
+		NOE_Q2 <= NOE_Q1 after 1 ns;
+	end if;
+end process;
+
+
+TRISTATE <= NE_Q2 or NOE_Q2 after 1 ns;
+
+
+-------------------------------------------------------------------------------
+-- P_DATA
+-------------------------------------------------------------------------------
+P_DATA: process(TRISTATE, DATA_OUT)
+begin
+	if (TRISTATE = '1') then
+		DATA <= (others => 'Z');
+	else
+     	DATA <= DATA_OUT;
+	end if;
+end process;
+
+P_DATA_Q: process(CLK_SYN, RESET_N)
+begin
+	if (RESET_N = '0') then
+		DATA_Q1 <= (others => '0') after 1 ns;
+		DATA_Q2 <= (others => '0') after 1 ns;
+		Y <= (others => '0') after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		DATA_Q1 <= DATA after 1 ns; -- IOB
+		DATA_Q2 <= DATA_Q1 after 1 ns;
+		if (EN = '1') then
+			Y <= DATA_Q2 after 1 ns;
+		end if;
+	end if;
+end process;
+
+-------------------------------------------------------------------------------
+-- 2's Complement
+-------------------------------------------------------------------------------
+P_CMPLMNT: process(W, Y_PE)
+begin
+	if (Y_PE(15) = '1') then
+		Y_CHECK <= not(Y_PE) + 1;
+		W_CHECK <= not(W) + 1;
+	else
+		Y_CHECK <= Y_PE;
+		W_CHECK <= W;
+	end if;
+end process;
+
+
+-------------------------------------------------------------------------------
+-- Mode select
+-------------------------------------------------------------------------------
+EN_PE		<= EN_SYNC when SYNC_MODE else EN;
+Y_PE		<= Y_SYNC when SYNC_MODE else Y;
+DATA_OUT	<= OUT_FIFO(OUT_RD) when SYNC_MODE else W_CHECK;
+RDY			<= WAIT_N when SYNC_MODE else RDY_PE;
+
+
+-------------------------------------------------------------------------------
+-- SYNC_MODE: P_CLK_FSMC
+-- Oversamples FSMC_CLK with CLK_SYN. A data beat is a rising FSMC_CLK edge
+-- while NE is low and the configured latency has passed.
+-------------------------------------------------------------------------------
+P_CLK_FSMC: process(CLK_SYN, RESET_N)
+begin
+	if (RESET_N = '0') then
+		CLK_FSMC_Q1 <= '0' after 1 ns;
+		CLK_FSMC_Q2 <= '0' after 1 ns;
+		CLK_FSMC_Q3 <= '0' after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		CLK_FSMC_Q1 <= CLK_FSMC after 1 ns; -- IOB
+		CLK_FSMC_Q2 <= CLK_FSMC_Q1 after 1 ns;
+		CLK_FSMC_Q3 <= CLK_FSMC_Q2 after 1 ns;
+	end if;
+end process;
+
+
+FSMC_EDGE <= CLK_FSMC_Q2 and not CLK_FSMC_Q3 after 1 ns;
+
+
+P_LATENCY: process(CLK_SYN, RESET_N)
+begin
+	if (RESET_N = '0') then
+		LAT_CNT <= 0 after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		if (NE_Q2 = '1') then
+			LAT_CNT <= 0 after 1 ns;
+		elsif (FSMC_EDGE = '1' and LAT_CNT < LATENCY) then
+			LAT_CNT <= LAT_CNT + 1 after 1 ns;
+		end if;
+	end if;
+end process;
+
+
+BEAT <= '1' when (FSMC_EDGE = '1' and NE_Q2 = '0' and LAT_CNT = LATENCY) else '0';
+
+
+-------------------------------------------------------------------------------
+-- SYNC_MODE: P_FIFO
+-- Write beats fill IN_FIFO, read beats drain OUT_FIFO. EQ_PE processes one
+-- word after another from IN_FIFO into OUT_FIFO using the same START
+-- handshake as the asynchronous mode.
+-------------------------------------------------------------------------------
+P_FIFO: process(CLK_SYN, RESET_N)
+	variable IN_PUSH, IN_POP, OUT_PUSH, OUT_POP : boolean;
+begin
+	if (RESET_N = '0') then
+		IN_WR <= 0 after 1 ns;
+		IN_RD <= 0 after 1 ns;
+		IN_CNT <= 0 after 1 ns;
+		OUT_WR <= 0 after 1 ns;
+		OUT_RD <= 0 after 1 ns;
+		OUT_CNT <= 0 after 1 ns;
+		PE_STATE <= PE_IDLE after 1 ns;
+		EN_SYNC <= '0' after 1 ns;
+		Y_SYNC <= (others => '0') after 1 ns;
+		RDY_Q1 <= '1' after 1 ns;
+		RDY_Q2 <= '1' after 1 ns;
+	elsif (CLK_SYN = '1' and CLK_SYN'event) then
+		RDY_Q1 <= RDY_PE after 1 ns;
+		RDY_Q2 <= RDY_Q1 after 1 ns;
+		EN_SYNC <= '0' after 1 ns;
+
+		IN_PUSH := (BEAT = '1' and NWE_Q2 = '0' and IN_CNT < FIFO_DEPTH);
+		OUT_POP := (BEAT = '1' and NOE_Q2 = '0' and OUT_CNT > 0);
+		IN_POP := false;
+		OUT_PUSH := false;
+
+		case PE_STATE is
+			when PE_IDLE	=>	if (IN_CNT > 0 and OUT_CNT < FIFO_DEPTH) then
+									Y_SYNC <= IN_FIFO(IN_RD) after 1 ns;
+									EN_SYNC <= '1' after 1 ns;
+									IN_POP := true;
+									PE_STATE <= PE_START after 1 ns;
+								end if;
+			when PE_START	=>	if (RDY_Q2 = '0') then
+									PE_STATE <= PE_DONE after 1 ns;
+								end if;
+			when PE_DONE	=>	if (RDY_Q2 = '1') then
+									OUT_PUSH := true;
+									PE_STATE <= PE_IDLE after 1 ns;
+								end if;
+		end case;
+
+		if IN_PUSH then
+			IN_FIFO(IN_WR) <= DATA_Q2 after 1 ns;
+			IN_WR <= (IN_WR + 1) mod FIFO_DEPTH after 1 ns;
+		end if;
+		if IN_POP then
+			IN_RD <= (IN_RD + 1) mod FIFO_DEPTH after 1 ns;
+		end if;
+		if (IN_PUSH and not IN_POP) then
+			IN_CNT <= IN_CNT + 1 after 1 ns;
+		elsif (IN_POP and not IN_PUSH) then
+			IN_CNT <= IN_CNT - 1 after 1 ns;
+		end if;
+
+		if OUT_PUSH then
+			OUT_FIFO(OUT_WR) <= W_CHECK after 1 ns;
+			OUT_WR <= (OUT_WR + 1) mod FIFO_DEPTH after 1 ns;
+		end if;
+		if OUT_POP then
+			OUT_RD <= (OUT_RD + 1) mod FIFO_DEPTH after 1 ns;
+		end if;
+		if (OUT_PUSH and not OUT_POP) then
+			OUT_CNT <= OUT_CNT + 1 after 1 ns;
+		elsif (OUT_POP and not OUT_PUSH) then
+			OUT_CNT <= OUT_CNT - 1 after 1 ns;
+		end if;
+	end if;
+end process;
+
+
+-- NWAIT stalls the burst on an empty OUT_FIFO (read) or a full IN_FIFO (write)
+WAIT_N <= '0' when ((NOE_Q2 = '0' and OUT_CNT = 0) or (NWE_Q2 = '0' and IN_CNT = FIFO_DEPTH)) else '1';
+
+-------------------------------------------------------------------------------
+-- EQ_PE instantiation
+-------------------------------------------------------------------------------
+EQ_PE_C : EQ_PE
+	port map (
+		CLK_PE	=> CLK_PE,
+		RESET_N	=> RESET_N,
+		START	=> START,
+		Y		=> Y_CHECK,
+		RDY		=> RDY_PE,
+		W		=> W
+	);
+
+
+end FSMC_ARCH;
@@ -1,552 +1,2418 @@
- /**
- * @{
- *
- * @brief     Low-level driver implementation for at25df641 flash memory.
- * @author    Copyright (C) Rene Herthel <rene-herthel@outlook.de>
- * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
- *
- * @}
- */
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <stm32f4xx.h>
-#include "driver/at25df641.h"
-#include "driver/gpio.h"
-#include "driver/spi.h"
-#include "driver/config/periph_conf.h"
-#include "driver/define/at25df641_def.h"
-#include "driver/debug.h"
-
-/** initialize a port_pin for CS */
-#define INIT_CS(port, pin) (gpio_init(GPIO_DIR_OUT, port, pin))
-/** set a port-pin for CS */
-#define SET_CS(port, pin)  (gpio_set(port, pin))
-/** clear a port-pin for CS */
-#define CLR_CS(port, pin)  (gpio_clear(port, pin))
-
-/** Masks different bytes from the config array for better access */
-#define CMD(x)             (at25df641_cfg[x].cmd)
-#define CMD_SIZ(x)         (at25df641_cfg[x].cmd_size)
-#define ADDR(x)            (at25df641_cfg[x].address)
-#define DATA(x)            (at25df641_cfg[x].data)
-#define SIZE(x)            (at25df641_cfg[x].data_size)
-#define PORT(x)            (at25df641_cfg[x].port)
-#define PIN(x)             (at25df641_cfg[x].pin)
-
-/** Dummy byte */
-#define DUMMY              (0xFF)
-
-/**
- * @brief Array holding all needed information for all devices
- */
-at25df641_t at25df641_cfg[] = {
-    /*data, address, data_size, cmd, cmd_size, port, pin*/
-    {0, 0, 0, 0x00, 0, WORK_CS_PORT, WORK_CS_PIN},
-    {0, 0, 0, 0x00, 0, ORIG_CS_PORT, ORIG_CS_PIN},
-    /** Add here more devices to use more physical components */
-};
-
-/**
- * @brief Reads bytes from the memory
- */
-void read_spi(int length, unsigned char *data)
-{
-    unsigned char val;
-    int i = 0;
-
-    while (length > 0)
-    {
-        spi_transfer_byte(SPI_0, DUMMY, &val);
-        data[i] = val;
-        i++;
-        length--;
-    }
-}
-
-/**
- * @brief Writes bytes to the memory
- */
-void write_spi(int length, unsigned char *data)
-{
-    unsigned char val;
-    int i = 0;
-
-    while (length > 0)
-    {
-        val = data[i];
-        spi_transfer_byte(SPI_0, val, NULL);
-        i++;
-        length--;
-    }
-}
-
-/**
- * @brief Builds and send a package included cmd & addr
- */
-static void _package(at25df641_dev_t dev)
-{
-    unsigned char buf[4];
-
-    buf[0] = (CMD(dev) & 0x000000FF);
-    buf[1] = ((ADDR(dev) & 0xFF0000) >> 16); // 0000FF
-    buf[2] = ((ADDR(dev) & 0x00FF00) >> 8);  // 0000FF
-    buf[3] = (ADDR(dev) & 0x0000FF);         // 0000FF
-
-    write_spi(CMD_SIZ(dev), buf);
-}
-
-int at25df641_command_handler(at25df641_dev_t dev)
-{
-    CLR_CS(PORT(dev), PIN(dev)); /**< select chip */
-
-    _package(dev);
-
-    if(CMD(dev) == AT25DF641_OPCODE_RD_ARRY)
-    {
-        spi_transfer_byte(SPI_0, DUMMY, NULL);
-    }
-
-    if ((CMD(dev) == AT25DF641_OPCODE_RD_ID) || (CMD(dev) == AT25DF641_OPCODE_RD_ARRY) || (CMD(dev) == AT25DF641_OPCODE_RD_SR))
-    {
-        read_spi(SIZE(dev), DATA(dev));
-    }
-    else if ((CMD(dev) == AT25DF641_OPCODE_WR_SR_FRST_BYTE) || (CMD(dev) == AT25DF641_OPCODE_BYTE_PROGR))
-    {
-        write_spi(SIZE(dev), DATA(dev));
-    }
-
-    SET_CS(PORT(dev), PIN(dev)); /**< deselect chip */
-
-    return OK;
-}
-
-int at25df641_init(at25df641_dev_t dev)
-{
-    /* intialize chip select with predefined device */
-    INIT_CS(PORT(dev), PIN(dev));
-
-    /* deselect chip */
-    SET_CS(PORT(dev), PIN(dev));
-
-    return at25df641_check_id(dev);
-}
-
-int at25df641_read_id(at25df641_dev_t dev, uint32_t *id_val)
-{
-    int status;
-
-    /* initialize a new command */
-    CMD(dev) = AT25DF641_OPCODE_RD_ID;
-    CMD_SIZ(dev) = 1;
-    DATA(dev) = (unsigned char*) id_val;
-    SIZE(dev) = 3;
-    ADDR(dev) = 0;
-
-    status = at25df641_command_handler(dev);
-
-    *id_val &= 0x00FFFFFF; // Mask the id out.
-
-    return status;
-}
-
-int at25df641_check_id(at25df641_dev_t dev)
-{
-    uint32_t val;
-
-    /* read memory device id */
-    at25df641_read_id(dev, &val);
-
-    if (val == AT25DF641_DEV_ID)
-    {
-        DMSG("Id for device %i = %x\n", dev, val);
-        return OK;
-    }
-    else
-    {
-        return ERROR_ID;
-    }
-
-}
-
-int at25df641_read(at25df641_dev_t dev, unsigned char *data, uint16_t size, uint32_t addr)
-{
-    /* Check if address plus size is out of bound */
-    if ((size + addr) > AT25DF641_MEM_SIZE)
-    {
-        DMSG("_read OOB - addr: 0x%x, size: %d\n", addr, size);
-        return ERROR_OUT_OF_BOUND;
-    }
-
-    /* initialize a new command */
-    CMD(dev) = AT25DF641_OPCODE_RD_ARRY;
-    CMD_SIZ(dev) = 4;
-    DATA(dev) = data;
-    SIZE(dev) = size;
-    ADDR(dev) = addr;
-
-    //DMSG("ADDR(dev) = %x\n", ADDR(dev));
-
-    return at25df641_command_handler(dev);
-}
-
-int at25df641_write(at25df641_dev_t dev,unsigned char *data, uint16_t size, uint32_t addr)
-{
-    unsigned char status;
-    uint32_t write_size;
-
-    at25df641_chip_protect(dev, UNPROTECT);
-
-    /* Check if address plus size is out of bound */
-    if ((size + addr) > AT25DF641_MEM_SIZE)
-    {
-        return ERROR_OUT_OF_BOUND;
-    }
-
-    /* program one page after another */
-    while (size > 0)
-    {
-        /* compute the number of bytes to program in page */
-        write_size = MINIMUM(size, AT25DF641_PAGE_SIZE - (addr % AT25DF641_PAGE_SIZE));
-
-        /* enable critical write operation */
-        if (at25df641_enable_write(dev) != OK)
-        {
-            return ERROR_DEFAULT;
-        }
-
-        /* initialize a new command */
-        CMD(dev) = AT25DF641_OPCODE_BYTE_PROGR;
-        CMD_SIZ(dev) = 4;
-        DATA(dev) = data;
-        SIZE(dev) = write_size;
-        ADDR(dev) = addr;
-
-        /* execute command */
-        if (at25df641_command_handler(dev) != OK)
-        {
-            return ERROR_DEFAULT;
-        }
-
-        /* wait til the command is executed */
-        if (at25df641_wait_rdy(dev) != OK )
-        {
-            return ERROR_DEFAULT;
-        }
-
-        /* read the status register */
-        if (at25df641_read_status(dev, &status) != OK)
-        {
-            return ERROR_DEFAULT;
-        }
-
-        /* Check if the writing process had an error */
-        if ((status & AT25DF641_MASK_SR_EPE) != AT25DF641_SR_EPE_SUCCESS)
-        {
-            return ERROR_WRITE;
-        }
-
-        data += write_size; /**< increment data buffer */
-        size -= write_size; /**< decrement number of bytes to write */
-        addr += write_size; /**< increment address */
-    } /* while (size > 0) */
-
-    at25df641_chip_protect(dev, PROTECT);
-
-    return OK;
-}
-
-int at25df641_enable_write(at25df641_dev_t dev)
-{
-    int status;
-    /* initialize a new command */
-    CMD(dev) = AT25DF641_OPCODE_WR_EN;
-    CMD_SIZ(dev) = 1;
-    DATA(dev) = NULL;
-    SIZE(dev) = 0;
-    ADDR(dev) = 0;
-
-    status = at25df641_command_handler(dev);
-
-    /* wait til command is executed */
-    if (at25df641_wait_rdy(dev) != OK )
-    {
-        return ERROR_DEFAULT;
-    }
-
-    return status;
-}
-
-int at25df641_read_status(at25df641_dev_t dev, unsigned char *status)
-{
-    /* initialize a new command */
-    CMD(dev) = AT25DF641_OPCODE_RD_SR;
-    CMD_SIZ(dev) = 1;
-    DATA(dev) = status;
-    SIZE(dev) = 1;
-    ADDR(dev) = 0;
-
-    return at25df641_command_handler(dev);
-}
-
-int at25df641_chip_protect(at25df641_dev_t dev, at25df641_prot_t prot_type)
-{
-    unsigned char tmp;
-
-    /* enable critical write operation */
-    if (at25df641_enable_write(dev) != OK)
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* wait til command is executed */
-    if (at25df641_wait_rdy(dev) != OK )
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* write one byte in the status register */
-    if (prot_type == PROTECT)
-    {
-        if ((at25df641_read_status(dev, &tmp)) != OK)
-        {
-            return ERROR_DEFAULT;
-        }
-
-        /* write the old status with new status in status register */
-        if ((at25df641_write_status(dev, tmp | AT25DF641_GLOBAL_PROTECT_VALUE)) != OK)
-        {
-            return ERROR_DEFAULT;
-        }
-    }
-    else
-    {
-        if ((at25df641_write_status(dev, 0x00)) != OK)
-        {
-            return ERROR_DEFAULT;
-        }
-    }
-
-    /* read the new status register */
-    if ((at25df641_read_status(dev, &tmp)) != OK)
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* check if the corresponding flag is set or not */
-    if (prot_type == PROTECT)
-    {
-        if ((tmp & AT25DF641_MASK_SR_SWP) == AT25DF641_SR_SWP_NONE)
-        {
-            return ERROR_UNPROTECTED;
-        }
-    }
-    else
-    {
-        if ((tmp & (AT25DF641_MASK_SR_SWP | AT25DF641_MASK_SR_SPRL)) != 0x00)
-        {
-            return ERROR_PROTECTED;
-        }
-    }
-
-    return OK;
-}
-
-int at25df641_write_status(at25df641_dev_t dev, unsigned char data)
-{
-    /* initialize a new command */
-    CMD(dev) = AT25DF641_OPCODE_WR_SR_FRST_BYTE;
-    CMD_SIZ(dev) = 1;
-    DATA(dev) = (unsigned char *) &data; // Byte to write.
-    SIZE(dev) = 1;                       // Write one Byte.
-    ADDR(dev) = 0;                       // No address needed.
-
-    return at25df641_command_handler(dev);
-}
-
-int at25df641_erase_block(at25df641_dev_t dev, uint32_t addr, at25df641_erase_t erase_cmd)
-{
-    unsigned char status;
-
-    at25df641_chip_protect(dev, UNPROTECT);
-
-    /* check if address is out of bounds */
-    if (addr > AT25DF641_MEM_SIZE)
-    {
-        return ERROR_OUT_OF_BOUND;
-    }
-
-    /* read the status register */
-    if (at25df641_read_status(dev, &status) != OK)
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* check if device is busy */
-    if ((status & AT25DF641_MASK_SR_RDYBSY) != AT25DF641_SR_RDYBSY_READY)
-    {
-        return ERROR_BUSY;
-    }
-
-    /* check if some sectors are protected */
-    if ((status & AT25DF641_MASK_SR_SWP) != AT25DF641_SR_SWP_NONE)
-    {
-        return ERROR_PROTECTED;
-    }
-
-    /* enable critical write operation */
-    if (at25df641_enable_write(dev) != OK)
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* initialize a new command */
-    CMD(dev) = erase_cmd; // operation code.
-    CMD_SIZ(dev) = 4;
-    DATA(dev) = NULL;     // No data to transmitt.
-    SIZE(dev) = 1;        // Command size is 1 Byte.
-    ADDR(dev) = addr;     // which address should be erased.
-
-    /* execute command */
-    if (at25df641_command_handler(dev) != OK)
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* wait til command is executed */
-    if (at25df641_wait_rdy(dev) != OK )
-    {
-        return ERROR_DEFAULT;
-    }
-
-    at25df641_chip_protect(dev, PROTECT);
-
-    return OK;
-}
-
-int at25df641_wait_rdy(at25df641_dev_t dev)
-{
-    unsigned char status;
-    unsigned char ready = 0;
-
-    /* polling the status register to check busy bit */
-    while (!ready)
-    {
-        if (at25df641_read_status(dev, &status) != OK)
-        {
-            return ERROR_DEFAULT;
-        }
-
-        if ((status & AT25DF641_MASK_SR_RDYBSY) == AT25DF641_SR_RDYBSY_READY)
-        {
-        ready = 1;
-        }
-    }
-
-    return OK;
-}
-
-int at25df641_compare(at25df641_dev_t fir, at25df641_dev_t sec, uint16_t size, uint32_t address)
-{
-    int i, counter = 0;
-    unsigned char work_buf[AT25DF641_PAGE_SIZE];
-    unsigned char orig_buf[AT25DF641_PAGE_SIZE];
-
-    at25df641_read(fir, work_buf, size, address);
-    at25df641_read(sec, orig_buf, size, address);
-
-    for (i = 0; i < size; i++)
-    {
-        if (work_buf[i] != orig_buf[i])
-        {
-            counter++;
-        }
-    }
-
-    return OK;
-}
-
-int at25df641_chip_erase(at25df641_dev_t dev)
-{
-    at25df641_chip_protect(dev, UNPROTECT);
-
-    /* enable critical write operation */
-    if (at25df641_enable_write(dev) != OK)
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* wait til command is executed */
-    if (at25df641_wait_rdy(dev) != OK )
-    {
-        return ERROR_DEFAULT;
-    }
-
-    CMD(dev) = AT25DF641_OPCODE_CHIP_ERASE;
-    CMD_SIZ(dev) = 1;
-    DATA(dev) = NULL;
-    SIZE(dev) = 0;
-    ADDR(dev) = 0;
-
-    /* execute command */
-    if (at25df641_command_handler(dev) != OK)
-    {
-        return ERROR_DEFAULT;
-    }
-
-    /* wait til command is executed */
-    if (at25df641_wait_rdy(dev) != OK )
-    {
-        return ERROR_DEFAULT;
-    }
-
-    at25df641_chip_protect(dev, PROTECT);
-
-    return OK;
-}
-
-int at25df641_copy_all(void)
-{
-    int i;
-    int status;
-    unsigned char buf[AT25DF641_PAGE_SIZE];
-
-    for (i = 0; i < MEM_DIV_PAGE_SIZE; i++)
-    {
-        if ((status = at25df641_read(AT25DF641_1, buf, AT25DF641_PAGE_SIZE, AT25DF641_PAGE_SIZE * i)) != OK)
-        {
-            return status;
-        }
-
-        if ((status = at25df641_write(AT25DF641_0, buf, AT25DF641_PAGE_SIZE, AT25DF641_PAGE_SIZE * i)) != OK)
-        {
-            return status;
-        }
-    }
-
-    return OK;
-}
-
-int at25df641_compare_all(void)
-{
-    int j, i;
-    int	counter = 0;
-    unsigned char work_buf[AT25DF641_PAGE_SIZE];
-    unsigned char orig_buf[AT25DF641_PAGE_SIZE];
-
-    for (j = 0; j < MEM_DIV_PAGE_SIZE; j++)
-    {
-        at25df641_read(AT25DF641_0, work_buf, AT25DF641_PAGE_SIZE, AT25DF641_PAGE_SIZE * j);
-        at25df641_read(AT25DF641_1, orig_buf, AT25DF641_PAGE_SIZE, AT25DF641_PAGE_SIZE * j);
-
-        for (i = 0; i < AT25DF641_PAGE_SIZE; i++)
-        {
-            if (work_buf[i] != orig_buf[i])
-            {
-                counter++;
-            }
-        }
-    }
-
-    return OK;
-}
+ /**
+ * @{
+ *
+ * @brief     Low-level driver implementation for at25df641 flash memory.
+ * @author    Copyright (C) Rene Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stm32f4xx.h>
+#include "driver/at25df641.h"
+#include "driver/gpio.h"
+#include "driver/spi.h"
+#include "driver/crc.h"
+#include "driver/config/periph_conf.h"
+#include "driver/define/at25df641_def.h"
+#include "driver/debug.h"
+
+/** initialize a port_pin for CS */
+#define INIT_CS(port, pin) (gpio_init(GPIO_DIR_OUT, port, pin))
+/** set a port-pin for CS */
+#define SET_CS(port, pin)  (gpio_set(port, pin))
+/** clear a port-pin for CS */
+#define CLR_CS(port, pin)  (gpio_clear(port, pin))
+
+/** Masks different bytes from the config array for better access */
+#define CMD(x)             (at25df641_cfg[x].cmd)
+#define CMD_SIZ(x)         (at25df641_cfg[x].cmd_size)
+#define ADDR(x)            (at25df641_cfg[x].address)
+#define DATA(x)            (at25df641_cfg[x].data)
+#define SIZE(x)            (at25df641_cfg[x].data_size)
+#define PORT(x)            (at25df641_cfg[x].port)
+#define PIN(x)             (at25df641_cfg[x].pin)
+#define MODE(x)            (at25df641_cfg[x].read_mode)
+#define STRM_ADDR(x)       (at25df641_cfg[x].stream_addr)
+#define STRM_OPEN(x)       (at25df641_cfg[x].stream_open)
+#define STRM_ACT(x)        (at25df641_cfg[x].stream_active)
+
+/** Dummy byte */
+#define DUMMY              (0xFF)
+/** Value of the stream_active flag, the chip is selected when not 0 */
+#define STREAM_SINGLE      (1)
+
+/** Maximum number of bytes of one DMA transfer */
+#define DMA_MAX_SIZE       (0xFFFF)
+
+/** Waits til the bus is owned, only in thread context */
+#define BUS_LOCK()         while (spi_acquire(SPI_0) != 0)
+/** Releases the bus */
+#define BUS_UNLOCK()       (spi_release(SPI_0))
+
+/** Bytes verified per CRC, read by DMA from both chips */
+#define VERIFY_BLOCK       (4096)
+
+/** Typical erase times in ms of 4KB, 32KB and 64KB, to choose the commands */
+#define ERASE_TIME_4KB     (50)
+#define ERASE_TIME_32KB    (250)
+#define ERASE_TIME_64KB    (400)
+
+/** States of the program/erase engine */
+#define PE_IDLE            (0)  /**< no operation */
+#define PE_BUSY            (1)  /**< program or erase running in the chip */
+#define PE_PROTECT         (2)  /**< protection is written after the operation */
+#define PE_START           (3)  /**< unprotection is written, the first step follows */
+
+/**
+ * @brief State of the running asynchronous read
+ */
+typedef struct {
+    at25df641_dev_t dev;  /**< device which is selected */
+    unsigned char *data;  /**< next destination in the read buffer */
+    uint32_t size;        /**< bytes left to read after the running chunk */
+    uint8_t keep_cs;      /**< flag if the chip stays selected (stream) */
+    at25df641_cb_t cb;    /**< callback for the finished read */
+    void *arg;            /**< argument of the callback */
+    volatile uint8_t busy;/**< flag if a read is running */
+} at25df641_async_t;
+
+static at25df641_async_t async_rd;
+
+/**
+ * @brief State of the running program/erase operation
+ */
+typedef struct {
+    uint8_t cmd;                /**< program or erase opcode */
+    const unsigned char *data;  /**< next bytes to program */
+    uint32_t addr;              /**< next page to program or block to erase */
+    uint32_t size;              /**< bytes left to program */
+    uint32_t sector;            /**< 64KB sector of the running step */
+    int status;                 /**< result for the callback */
+    at25df641_cb_t cb;          /**< callback for the finished operation */
+    void *arg;                  /**< argument of the callback */
+    volatile uint8_t state;     /**< PE_x */
+    volatile uint8_t suspended; /**< flag if suspended for a read */
+} at25df641_pe_t;
+
+/** Program/erase operations, one per device, the chips work in parallel */
+static at25df641_pe_t pe[AT25DF641_NUMOF];
+
+/** Queued transactions, sorted by priority */
+static at25df641_trans_t *queue;
+/** Read of the playback, it starts before the queue */
+static at25df641_trans_t *volatile play;
+
+/** Buffers of the verification, word aligned for the CRC unit */
+static uint32_t verify_buf[2][VERIFY_BLOCK / 4];
+/** Flags of the finished verification reads */
+static volatile uint8_t verify_done[2];
+/** Results of the verification reads */
+static volatile int verify_status[2];
+
+#if AT25DF641_CACHE_PAGES
+/**
+ * @brief One page of the read cache
+ */
+typedef struct {
+    unsigned char data[AT25DF641_PAGE_SIZE]; /**< content of the page */
+    uint32_t addr;              /**< address of the page */
+    volatile uint32_t used;     /**< time of the last use, 0 if empty */
+    at25df641_dev_t dev;        /**< device of the page */
+} at25df641_line_t;
+
+static at25df641_line_t cache[AT25DF641_CACHE_PAGES];
+/** Counter for the LRU times of the cache */
+static uint32_t cache_time;
+/** Incremented by every invalidation, also from the tick */
+static volatile uint32_t cache_gen;
+#endif
+
+static at25df641_cache_stats_t cache_stats;
+
+#if AT25DF641_WCB_PAGES
+/**
+ * @brief One page of the write-combining buffer
+ */
+typedef struct {
+    unsigned char data[AT25DF641_PAGE_SIZE]; /**< written bytes, 0xFF elsewhere */
+    uint32_t addr;              /**< address of the page */
+    uint32_t since;             /**< time of the first write in ms */
+    uint16_t lo;                /**< first written byte in the page */
+    uint16_t hi;                /**< behind the last written byte, 0 if empty */
+    at25df641_dev_t dev;        /**< device of the page */
+} at25df641_wcb_t;
+
+static at25df641_wcb_t wcb[AT25DF641_WCB_PAGES];
+/** Time in ms, counted by the tick */
+static volatile uint32_t wcb_now;
+#endif
+
+static at25df641_wcb_stats_t wcb_stats;
+
+/**
+ * @brief Opcodes of the read modes, in order of at25df641_read_t
+ */
+static const uint8_t read_opcode[] = {
+    AT25DF641_OPCODE_RD_ARRY_LOW_FREQ,
+    AT25DF641_OPCODE_RD_ARRY,
+    AT25DF641_OPCODE_RD_ARRY_MAX_FREQ,
+};
+
+/**
+ * @brief Array holding all needed information for all devices
+ */
+at25df641_t at25df641_cfg[] = {
+    /*data, address, data_size, cmd, cmd_size, port, pin, read_mode, stream*/
+    {0, 0, 0, 0x00, 0, WORK_CS_PORT, WORK_CS_PIN, READ_FAST, 0, 0, 0},
+    {0, 0, 0, 0x00, 0, ORIG_CS_PORT, ORIG_CS_PIN, READ_FAST, 0, 0, 0},
+    /** Add here more devices to use more physical components */
+};
+
+/**
+ * @brief Reads bytes from the memory
+ */
+void read_spi(int length, unsigned char *data)
+{
+    spi_transfer_buf(SPI_0, NULL, data, length);
+}
+
+/**
+ * @brief Writes bytes to the memory
+ */
+void write_spi(int length, unsigned char *data)
+{
+    spi_transfer_buf(SPI_0, data, NULL, length);
+}
+
+/**
+ * @brief Builds and send a package included cmd & addr
+ */
+static void _package(at25df641_dev_t dev)
+{
+    unsigned char buf[4];
+
+    buf[0] = (CMD(dev) & 0x000000FF);
+    buf[1] = ((ADDR(dev) & 0xFF0000) >> 16); // 0000FF
+    buf[2] = ((ADDR(dev) & 0x00FF00) >> 8);  // 0000FF
+    buf[3] = (ADDR(dev) & 0x0000FF);         // 0000FF
+
+    write_spi(CMD_SIZ(dev), buf);
+}
+
+/**
+ * @brief Starts the next DMA chunk or finishes the asynchronous read
+ *
+ * A failed chunk ends the read with ERROR_DEFAULT. The chip is deselected
+ * then, so a stream restarts its read command with the next read.
+ */
+static void _read_async_next(void *arg, int result)
+{
+    uint16_t chunk;
+    at25df641_cb_t cb;
+    int status = OK;
+
+    (void)arg;
+
+    if (result != 0)
+    {
+        async_rd.size = 0;
+        async_rd.keep_cs = 0;
+        STRM_ACT(async_rd.dev) = 0;
+        status = ERROR_DEFAULT;
+    }
+
+    if (async_rd.size > 0)
+    {
+        chunk = MINIMUM(async_rd.size, DMA_MAX_SIZE);
+        async_rd.size -= chunk;
+
+        if (spi_transfer_dma(SPI_0, NULL, async_rd.data, chunk, _read_async_next, NULL) == 0)
+        {
+            async_rd.data += chunk;
+            return;
+        }
+
+        async_rd.size = 0;
+        status = ERROR_DEFAULT;
+    }
+
+    if (!async_rd.keep_cs)
+    {
+        SET_CS(PORT(async_rd.dev), PIN(async_rd.dev)); /**< deselect chip */
+    }
+
+    cb = async_rd.cb;
+    async_rd.busy = 0;
+    BUS_UNLOCK();
+
+    if (cb != NULL)
+    {
+        cb(async_rd.arg, status);
+    }
+}
+
+/**
+ * @brief Deselects all chips which are held selected by a read stream
+ */
+static void _stream_suspend(void)
+{
+    int dev;
+
+    for (dev = 0; dev < AT25DF641_NUMOF; dev++)
+    {
+        if (STRM_ACT(dev))
+        {
+            SET_CS(PORT(dev), PIN(dev)); /**< deselect chip */
+            STRM_ACT(dev) = 0;
+        }
+    }
+}
+
+/**
+ * @brief Drops the cached pages which a program or erase command changes
+ *
+ * @param[in] size      bytes of a program command
+ */
+static void _cache_invalidate(at25df641_dev_t dev, uint8_t cmd, uint32_t addr, uint32_t size)
+{
+#if AT25DF641_CACHE_PAGES
+    int i;
+
+    switch (cmd)
+    {
+        case AT25DF641_OPCODE_BYTE_PROGR:
+            break;
+        case AT25DF641_OPCODE_BLOCK_ERASE_4KB:
+            size = 4 * 1024;
+            break;
+        case AT25DF641_OPCODE_BLOCK_ERASE_32KB:
+            size = 32 * 1024;
+            break;
+        case AT25DF641_OPCODE_BLOCK_ERASE_64KB:
+            size = AT25DF641_BLOCK_SIZE;
+            break;
+        case AT25DF641_OPCODE_CHIP_ERASE:
+            size = AT25DF641_MEM_SIZE;
+            break;
+        default:
+            return;
+    }
+
+    /* erases work on the aligned block */
+    if (cmd != AT25DF641_OPCODE_BYTE_PROGR)
+    {
+        addr &= ~(size - 1);
+    }
+
+    cache_gen++;
+
+    for (i = 0; i < AT25DF641_CACHE_PAGES; i++)
+    {
+        if (cache[i].used && (cache[i].dev == dev) &&
+            ((cache[i].addr + AT25DF641_PAGE_SIZE) > addr) && (cache[i].addr < (addr + size)))
+        {
+            cache[i].used = 0;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Sends a command with optional address, without touching the cfg
+ *
+ * The program/erase engine runs from the timer interrupt and must not
+ * change the command which is just built in thread context.
+ *
+ * @param[in] len       1 for the opcode only, 4 with address
+ */
+static void _raw_command(at25df641_dev_t dev, uint8_t cmd, uint32_t addr, int len,
+                         const unsigned char *data, uint32_t size)
+{
+    unsigned char buf[PACK_SIZ];
+
+    buf[0] = cmd;
+    buf[1] = ((addr & 0xFF0000) >> 16);
+    buf[2] = ((addr & 0x00FF00) >> 8);
+    buf[3] = (addr & 0x0000FF);
+
+    CLR_CS(PORT(dev), PIN(dev)); /**< select chip */
+    spi_transfer_buf(SPI_0, buf, NULL, len);
+
+    if (size > 0)
+    {
+        spi_transfer_buf(SPI_0, data, NULL, size);
+    }
+
+    SET_CS(PORT(dev), PIN(dev)); /**< deselect chip */
+
+    _cache_invalidate(dev, cmd, addr, size);
+}
+
+/**
+ * @brief Reads the status register, without touching the cfg
+ */
+static unsigned char _raw_status(at25df641_dev_t dev)
+{
+    unsigned char status;
+
+    CLR_CS(PORT(dev), PIN(dev)); /**< select chip */
+    spi_transfer_byte(SPI_0, AT25DF641_OPCODE_RD_SR, NULL);
+    spi_transfer_byte(SPI_0, DUMMY, &status);
+    SET_CS(PORT(dev), PIN(dev)); /**< deselect chip */
+
+    return status;
+}
+
+/**
+ * @brief Checks if a read overlaps the sector of the running program/erase step
+ *
+ * The chip returns undefined data of this sector while the step is suspended.
+ */
+static int _pe_hit(at25df641_dev_t dev, uint32_t addr, uint32_t size)
+{
+    uint32_t first = pe[dev].sector * AT25DF641_BLOCK_SIZE;
+
+    return (pe[dev].state == PE_BUSY) && (addr < (first + AT25DF641_BLOCK_SIZE)) &&
+           ((addr + size) > first);
+}
+
+/**
+ * @brief Suspends a running program/erase before the array of dev is read
+ *
+ * A read of the sector of the running step waits for the end of the step
+ * instead. The bus has to be owned and no stream may hold a chip selected.
+ */
+static void _pe_suspend(at25df641_dev_t dev, uint32_t addr, uint32_t size)
+{
+    if (pe[dev].state == PE_IDLE)
+    {
+        return;
+    }
+
+    if (_pe_hit(dev, addr, size))
+    {
+        if (pe[dev].suspended)
+        {
+            _raw_command(dev, AT25DF641_OPCODE_PROGR_RESUM, 0, 1, NULL, 0);
+            pe[dev].suspended = 0;
+        }
+    }
+    else if (pe[dev].suspended)
+    {
+        return;
+    }
+    else if (pe[dev].state == PE_BUSY)
+    {
+        /* protection writes can not be suspended, they are short */
+        _raw_command(dev, AT25DF641_OPCODE_PROGR_SUSP, 0, 1, NULL, 0);
+        pe[dev].suspended = 1;
+    }
+
+    /* a suspend is ignored if the operation just ended, both end ready */
+    while ((_raw_status(dev) & AT25DF641_MASK_SR_RDYBSY) != AT25DF641_SR_RDYBSY_READY);
+}
+
+/**
+ * @brief Starts the next page program or the erase of the operation
+ */
+static void _pe_issue(at25df641_dev_t dev)
+{
+    at25df641_pe_t *op = &pe[dev];
+    uint32_t chunk = 0;
+
+    _raw_command(dev, AT25DF641_OPCODE_WR_EN, 0, 1, NULL, 0);
+
+    if (op->cmd == AT25DF641_OPCODE_BYTE_PROGR)
+    {
+        chunk = MINIMUM(op->size, AT25DF641_PAGE_SIZE - (op->addr % AT25DF641_PAGE_SIZE));
+    }
+
+    op->sector = op->addr / AT25DF641_BLOCK_SIZE;
+
+    _raw_command(dev, op->cmd, op->addr, PACK_SIZ, op->data, chunk);
+
+    op->data += chunk;
+    op->addr += chunk;
+    op->size -= chunk;
+}
+
+/**
+ * @brief Returns the number of dummy bytes of a read array command
+ */
+static int _dummy_bytes(uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case AT25DF641_OPCODE_RD_ARRY:
+            return AT25DF641_DUMMY_RD_ARRY;
+        case AT25DF641_OPCODE_RD_ARRY_MAX_FREQ:
+            return AT25DF641_DUMMY_RD_ARRY_MAX_FREQ;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Checks if the command reads from the data array
+ */
+static int _is_read_array(uint8_t cmd)
+{
+    return (cmd == AT25DF641_OPCODE_RD_ARRY) || (cmd == AT25DF641_OPCODE_RD_ARRY_MAX_FREQ) ||
+           (cmd == AT25DF641_OPCODE_RD_ARRY_LOW_FREQ);
+}
+
+int at25df641_command_handler(at25df641_dev_t dev)
+{
+    int i;
+
+    /* the bus may be owned by a running asynchronous read */
+    BUS_LOCK();
+
+    _stream_suspend();
+
+    if (_is_read_array(CMD(dev)))
+    {
+        _pe_suspend(dev, ADDR(dev), SIZE(dev));
+    }
+
+    CLR_CS(PORT(dev), PIN(dev)); /**< select chip */
+
+    _package(dev);
+
+    for (i = 0; i < _dummy_bytes(CMD(dev)); i++)
+    {
+        spi_transfer_byte(SPI_0, DUMMY, NULL);
+    }
+
+    if ((CMD(dev) == AT25DF641_OPCODE_RD_ID) || _is_read_array(CMD(dev)) || (CMD(dev) == AT25DF641_OPCODE_RD_SR))
+    {
+        read_spi(SIZE(dev), DATA(dev));
+    }
+    else if ((CMD(dev) == AT25DF641_OPCODE_WR_SR_FRST_BYTE) || (CMD(dev) == AT25DF641_OPCODE_BYTE_PROGR))
+    {
+        write_spi(SIZE(dev), DATA(dev));
+    }
+
+    SET_CS(PORT(dev), PIN(dev)); /**< deselect chip */
+
+    _cache_invalidate(dev, CMD(dev), ADDR(dev), SIZE(dev));
+
+    BUS_UNLOCK();
+
+    return OK;
+}
+
+int at25df641_init(at25df641_dev_t dev)
+{
+    /* intialize chip select with predefined device */
+    INIT_CS(PORT(dev), PIN(dev));
+
+    /* deselect chip */
+    SET_CS(PORT(dev), PIN(dev));
+
+    return at25df641_check_id(dev);
+}
+
+int at25df641_read_id(at25df641_dev_t dev, uint32_t *id_val)
+{
+    int status;
+
+    /* initialize a new command */
+    CMD(dev) = AT25DF641_OPCODE_RD_ID;
+    CMD_SIZ(dev) = 1;
+    DATA(dev) = (unsigned char*) id_val;
+    SIZE(dev) = 3;
+    ADDR(dev) = 0;
+
+    status = at25df641_command_handler(dev);
+
+    *id_val &= 0x00FFFFFF; // Mask the id out.
+
+    return status;
+}
+
+int at25df641_check_id(at25df641_dev_t dev)
+{
+    uint32_t val;
+
+    /* read memory device id */
+    at25df641_read_id(dev, &val);
+
+    if (val == AT25DF641_DEV_ID)
+    {
+        DMSG("Id for device %i = %x\n", dev, val);
+        return OK;
+    }
+    else
+    {
+        return ERROR_ID;
+    }
+
+}
+
+/**
+ * @brief Reads from the data array with the read mode of the device
+ */
+static int _read_array(at25df641_dev_t dev, unsigned char *data, uint32_t size, uint32_t addr)
+{
+    /* initialize a new command */
+    CMD(dev) = read_opcode[MODE(dev)];
+    CMD_SIZ(dev) = 4;
+    DATA(dev) = data;
+    SIZE(dev) = size;
+    ADDR(dev) = addr;
+
+    //DMSG("ADDR(dev) = %x\n", ADDR(dev));
+
+    return at25df641_command_handler(dev);
+}
+
+#if AT25DF641_CACHE_PAGES
+/**
+ * @brief Returns the cached page or the least recently used line on a miss
+ *
+ * @param[out] *hit     1 if the page is cached
+ */
+static at25df641_line_t *_cache_line(at25df641_dev_t dev, uint32_t page, int *hit)
+{
+    at25df641_line_t *lru = &cache[0];
+    int i;
+
+    for (i = 0; i < AT25DF641_CACHE_PAGES; i++)
+    {
+        if (cache[i].used && (cache[i].dev == dev) && (cache[i].addr == page))
+        {
+            *hit = 1;
+            return &cache[i];
+        }
+
+        if (cache[i].used < lru->used)
+        {
+            lru = &cache[i];
+        }
+    }
+
+    *hit = 0;
+    return lru;
+}
+
+/**
+ * @brief Reads up to two pages through the cache
+ */
+static int _cache_read(at25df641_dev_t dev, unsigned char *data, uint32_t size, uint32_t addr)
+{
+    at25df641_line_t *line;
+    uint32_t page, chunk, gen;
+    int hit, status;
+
+    while (size > 0)
+    {
+        page = addr & ~(AT25DF641_PAGE_SIZE - 1);
+        chunk = MINIMUM(size, page + AT25DF641_PAGE_SIZE - addr);
+        gen = cache_gen;
+        line = _cache_line(dev, page, &hit);
+
+        if (hit)
+        {
+            cache_stats.hits++;
+        }
+        else
+        {
+            cache_stats.misses++;
+            line->used = 0;
+
+            if ((status = _read_array(dev, line->data, AT25DF641_PAGE_SIZE, page)) != OK)
+            {
+                return status;
+            }
+
+            line->dev = dev;
+            line->addr = page;
+        }
+
+        memcpy(data, &line->data[addr - page], chunk);
+
+        /* keep it only if nothing was programmed meanwhile, a page which
+         * is just programmed reads undefined. Invalidations own the bus. */
+        BUS_LOCK();
+
+        if ((gen == cache_gen) && (pe[dev].state == PE_IDLE))
+        {
+            /* 0 marks empty lines */
+            if (++cache_time == 0)
+            {
+                at25df641_cache_flush();
+                cache_time = 1;
+            }
+
+            line->used = cache_time;
+        }
+
+        BUS_UNLOCK();
+
+        data += chunk;
+        addr += chunk;
+        size -= chunk;
+    }
+
+    return OK;
+}
+#endif
+
+#if AT25DF641_WCB_PAGES
+/**
+ * @brief Returns the buffer of a page or an empty one, NULL if all are in use
+ */
+static at25df641_wcb_t *_wcb_page(at25df641_dev_t dev, uint32_t page)
+{
+    at25df641_wcb_t *empty = NULL;
+    int i;
+
+    for (i = 0; i < AT25DF641_WCB_PAGES; i++)
+    {
+        if ((wcb[i].hi > 0) && (wcb[i].dev == dev) && (wcb[i].addr == page))
+        {
+            return &wcb[i];
+        }
+
+        if ((wcb[i].hi == 0) && (empty == NULL))
+        {
+            empty = &wcb[i];
+        }
+    }
+
+    return empty;
+}
+
+/**
+ * @brief Checks if buffered pages overlap the given range
+ */
+static int _wcb_pending(at25df641_dev_t dev, uint32_t addr, uint32_t size)
+{
+    int i;
+
+    for (i = 0; i < AT25DF641_WCB_PAGES; i++)
+    {
+        if ((wcb[i].hi > 0) && (wcb[i].dev == dev) &&
+            ((wcb[i].addr + AT25DF641_PAGE_SIZE) > addr) && (wcb[i].addr < (addr + size)))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+#endif
+
+int at25df641_read(at25df641_dev_t dev, unsigned char *data, uint32_t size, uint32_t addr)
+{
+#if AT25DF641_WCB_PAGES
+    int status;
+#endif
+
+    /* Check if address plus size is out of bound */
+    if ((size + addr) > AT25DF641_MEM_SIZE)
+    {
+        DMSG("_read OOB - addr: 0x%x, size: %d\n", addr, size);
+        return ERROR_OUT_OF_BOUND;
+    }
+
+#if AT25DF641_WCB_PAGES
+    /* the buffered writes have to be in the chip */
+    if (_wcb_pending(dev, addr, size) && ((status = at25df641_wcb_flush()) != OK))
+    {
+        return status;
+    }
+#endif
+
+#if AT25DF641_CACHE_PAGES
+    /* small reads of metadata, bulk reads would only evict them */
+    if (size <= AT25DF641_PAGE_SIZE)
+    {
+        return _cache_read(dev, data, size, addr);
+    }
+#endif
+
+    return _read_array(dev, data, size, addr);
+}
+
+void at25df641_cache_stats(at25df641_cache_stats_t *stats)
+{
+    *stats = cache_stats;
+}
+
+void at25df641_cache_flush(void)
+{
+#if AT25DF641_CACHE_PAGES
+    int i;
+
+    cache_gen++;
+
+    for (i = 0; i < AT25DF641_CACHE_PAGES; i++)
+    {
+        cache[i].used = 0;
+    }
+#endif
+}
+
+/**
+ * @brief Selects the chip and sends a read array command with dummy bytes
+ *
+ * @param[in] size      bytes which will be read, to check them against a
+ *                      suspended program/erase
+ */
+static void _read_start(at25df641_dev_t dev, uint32_t addr, uint32_t size)
+{
+    unsigned char buf[PACK_SIZ + AT25DF641_DUMMY_RD_ARRY_MAX_FREQ];
+    int len = PACK_SIZ;
+
+    buf[0] = read_opcode[MODE(dev)];
+    buf[1] = ((addr & 0xFF0000) >> 16);
+    buf[2] = ((addr & 0x00FF00) >> 8);
+    buf[3] = (addr & 0x0000FF);
+
+    while (len < (PACK_SIZ + _dummy_bytes(buf[0])))
+    {
+        buf[len++] = DUMMY;
+    }
+
+    _pe_suspend(dev, addr, size);
+
+    CLR_CS(PORT(dev), PIN(dev)); /**< select chip */
+
+    write_spi(len, buf);
+}
+
+/**
+ * @brief Starts the DMA chunks of an asynchronous read, CS is already low
+ *
+ * The bus is owned by the read til its callback.
+ */
+static int _read_async_start(at25df641_dev_t dev, unsigned char *data,
+                             uint32_t size, int keep_cs, at25df641_cb_t cb,
+                             void *arg)
+{
+    async_rd.busy = 1;
+    async_rd.dev = dev;
+    async_rd.data = data;
+    async_rd.size = size;
+    async_rd.keep_cs = keep_cs;
+    async_rd.cb = cb;
+    async_rd.arg = arg;
+
+    _read_async_next(NULL, 0);
+
+    return OK;
+}
+
+int at25df641_read_async(at25df641_dev_t dev, unsigned char *data,
+                         uint32_t size, uint32_t addr, at25df641_cb_t cb,
+                         void *arg)
+{
+    /* Check if address plus size is out of bound */
+    if (((size + addr) > AT25DF641_MEM_SIZE) || (size == 0))
+    {
+        DMSG("_read_async OOB - addr: 0x%x, size: %d\n", addr, size);
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    /* may be called from interrupts, so never wait for the bus */
+    if (spi_acquire(SPI_0) != 0)
+    {
+        return ERROR_BUSY;
+    }
+
+    /* the sector of a running program/erase step can not be read without waiting */
+    if (_pe_hit(dev, addr, size))
+    {
+        BUS_UNLOCK();
+        return ERROR_BUSY;
+    }
+
+    _stream_suspend();
+
+    /* command and address are sent synchronously, the data via DMA */
+    _read_start(dev, addr, size);
+
+    return _read_async_start(dev, data, size, 0, cb, arg);
+}
+
+int at25df641_stream_open(at25df641_dev_t dev, uint32_t addr)
+{
+    if (addr >= AT25DF641_MEM_SIZE)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    at25df641_stream_close(dev);
+
+    STRM_ADDR(dev) = addr;
+    STRM_OPEN(dev) = 1;
+
+    return OK;
+}
+
+/**
+ * @brief Checks a stream read and (re)starts the read command if needed
+ *
+ * Owns the bus on success. The DMA variant never waits for the bus.
+ */
+static int _stream_prepare(at25df641_dev_t dev, uint32_t size, int dma)
+{
+    if (!STRM_OPEN(dev))
+    {
+        return ERROR_DEFAULT;
+    }
+
+    if ((STRM_ADDR(dev) + size) > AT25DF641_MEM_SIZE)
+    {
+        DMSG("_stream OOB - addr: 0x%x, size: %d\n", STRM_ADDR(dev), size);
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    if (dma)
+    {
+        if (spi_acquire(SPI_0) != 0)
+        {
+            return ERROR_BUSY;
+        }
+    }
+    else
+    {
+        BUS_LOCK();
+    }
+
+    /* the stream reached the sector of a running program/erase step, the
+     * DMA variant does not wait for its end, the other one restarts */
+    if (_pe_hit(dev, STRM_ADDR(dev), size))
+    {
+        if (dma)
+        {
+            BUS_UNLOCK();
+            return ERROR_BUSY;
+        }
+
+        _stream_suspend();
+    }
+
+    /* (re)start the command if the stream was interrupted */
+    if (!STRM_ACT(dev))
+    {
+        _stream_suspend();
+        _read_start(dev, STRM_ADDR(dev), size);
+        STRM_ACT(dev) = STREAM_SINGLE;
+    }
+
+    return OK;
+}
+
+int at25df641_stream_read(at25df641_dev_t dev, unsigned char *data,
+                          uint32_t size)
+{
+    int status;
+
+    if ((status = _stream_prepare(dev, size, 0)) != OK)
+    {
+        return status;
+    }
+
+    read_spi(size, data);
+
+    STRM_ADDR(dev) += size;
+
+    BUS_UNLOCK();
+
+    return OK;
+}
+
+int at25df641_stream_read_async(at25df641_dev_t dev, unsigned char *data,
+                                uint32_t size, at25df641_cb_t cb, void *arg)
+{
+    int status;
+
+    if (size == 0)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    if ((status = _stream_prepare(dev, size, 1)) != OK)
+    {
+        return status;
+    }
+
+    /* the cursor is advanced now, the bytes are valid with the callback */
+    STRM_ADDR(dev) += size;
+
+    return _read_async_start(dev, data, size, 1, cb, arg);
+}
+
+uint32_t at25df641_stream_tell(at25df641_dev_t dev)
+{
+    return STRM_ADDR(dev);
+}
+
+int at25df641_stream_close(at25df641_dev_t dev)
+{
+    BUS_LOCK();
+
+    if (STRM_ACT(dev))
+    {
+        SET_CS(PORT(dev), PIN(dev)); /**< deselect chip */
+        STRM_ACT(dev) = 0;
+    }
+
+    STRM_OPEN(dev) = 0;
+
+    BUS_UNLOCK();
+
+    return OK;
+}
+
+int at25df641_set_read_mode(at25df641_dev_t dev, at25df641_read_t mode)
+{
+    if (mode > READ_MAX_FREQ)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* the mode is used when the next read command is built */
+    BUS_LOCK();
+    MODE(dev) = mode;
+    BUS_UNLOCK();
+
+    return OK;
+}
+
+int at25df641_async_busy(void)
+{
+    return async_rd.busy;
+}
+
+/**
+ * @brief Programs bytes within one page, the chip is unprotected
+ */
+static int _program(at25df641_dev_t dev, const unsigned char *data, uint32_t size, uint32_t addr)
+{
+    unsigned char status;
+
+    /* enable critical write operation */
+    if (at25df641_enable_write(dev) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* initialize a new command */
+    CMD(dev) = AT25DF641_OPCODE_BYTE_PROGR;
+    CMD_SIZ(dev) = 4;
+    DATA(dev) = (unsigned char *)data;
+    SIZE(dev) = size;
+    ADDR(dev) = addr;
+
+    /* execute command */
+    if (at25df641_command_handler(dev) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* wait til the command is executed */
+    if (at25df641_wait_rdy(dev) != OK )
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* read the status register */
+    if (at25df641_read_status(dev, &status) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* Check if the writing process had an error */
+    if ((status & AT25DF641_MASK_SR_EPE) != AT25DF641_SR_EPE_SUCCESS)
+    {
+        return ERROR_WRITE;
+    }
+
+    return OK;
+}
+
+int at25df641_write(at25df641_dev_t dev,unsigned char *data, uint16_t size, uint32_t addr)
+{
+    uint32_t write_size;
+    int status;
+
+    if (pe[dev].state != PE_IDLE)
+    {
+        return ERROR_BUSY;
+    }
+
+    at25df641_chip_protect(dev, UNPROTECT);
+
+    /* Check if address plus size is out of bound */
+    if ((size + addr) > AT25DF641_MEM_SIZE)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    /* program one page after another */
+    while (size > 0)
+    {
+        /* compute the number of bytes to program in page */
+        write_size = MINIMUM(size, AT25DF641_PAGE_SIZE - (addr % AT25DF641_PAGE_SIZE));
+
+        if ((status = _program(dev, data, write_size, addr)) != OK)
+        {
+            return status;
+        }
+
+        data += write_size; /**< increment data buffer */
+        size -= write_size; /**< decrement number of bytes to write */
+        addr += write_size; /**< increment address */
+    } /* while (size > 0) */
+
+    at25df641_chip_protect(dev, PROTECT);
+
+    return OK;
+}
+
+int at25df641_wcb_write(at25df641_dev_t dev, const unsigned char *data, uint32_t size,
+                        uint32_t addr)
+{
+#if AT25DF641_WCB_PAGES
+    at25df641_wcb_t *buf;
+    uint32_t page, chunk, i;
+    int full = 0, status;
+
+    if ((size + addr) > AT25DF641_MEM_SIZE)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    wcb_stats.writes++;
+
+    while (size > 0)
+    {
+        page = addr & ~(AT25DF641_PAGE_SIZE - 1);
+        chunk = MINIMUM(size, page + AT25DF641_PAGE_SIZE - addr);
+
+        if ((buf = _wcb_page(dev, page)) == NULL)
+        {
+            if ((status = at25df641_wcb_flush()) != OK)
+            {
+                return status;
+            }
+
+            buf = _wcb_page(dev, page);
+        }
+
+        if (buf->hi == 0)
+        {
+            memset(buf->data, 0xFF, AT25DF641_PAGE_SIZE);
+            buf->dev = dev;
+            buf->addr = page;
+            buf->lo = addr - page;
+            buf->hi = addr - page;
+            buf->since = wcb_now;
+        }
+
+        /* the gaps keep 0xFF, programming it changes no bit */
+        for (i = 0; i < chunk; i++)
+        {
+            buf->data[addr - page + i] &= data[i];
+        }
+
+        buf->lo = MINIMUM(buf->lo, addr - page);
+        buf->hi = (buf->hi > (addr - page + chunk)) ? buf->hi : (addr - page + chunk);
+
+        data += chunk;
+        addr += chunk;
+        size -= chunk;
+    }
+
+    for (i = 0; i < AT25DF641_WCB_PAGES; i++)
+    {
+        full += ((wcb[i].lo == 0) && (wcb[i].hi == AT25DF641_PAGE_SIZE));
+    }
+
+    if (full >= AT25DF641_WCB_THRESHOLD)
+    {
+        return at25df641_wcb_flush();
+    }
+
+    return OK;
+#else
+    return at25df641_write(dev, (unsigned char *)data, size, addr);
+#endif
+}
+
+int at25df641_wcb_flush(void)
+{
+#if AT25DF641_WCB_PAGES
+    at25df641_dev_t dev;
+    int i, batch, status = OK;
+
+    for (dev = (at25df641_dev_t)0; dev < AT25DF641_NUMOF; dev++)
+    {
+        batch = 0;
+
+        for (i = 0; (i < AT25DF641_WCB_PAGES) && (status == OK); i++)
+        {
+            if ((wcb[i].hi == 0) || (wcb[i].dev != dev))
+            {
+                continue;
+            }
+
+            /* one unprotection for all pages of the chip */
+            if (!batch)
+            {
+                if (pe[dev].state != PE_IDLE)
+                {
+                    return ERROR_BUSY;
+                }
+
+                if ((status = at25df641_chip_protect(dev, UNPROTECT)) != OK)
+                {
+                    return status;
+                }
+
+                batch = 1;
+                wcb_stats.batches++;
+            }
+
+            status = _program(dev, &wcb[i].data[wcb[i].lo], wcb[i].hi - wcb[i].lo,
+                              wcb[i].addr + wcb[i].lo);
+            wcb[i].hi = 0;
+            wcb_stats.pages++;
+        }
+
+        if (batch)
+        {
+            at25df641_chip_protect(dev, PROTECT);
+        }
+
+        if (status != OK)
+        {
+            return status;
+        }
+    }
+#endif
+
+    return OK;
+}
+
+int at25df641_wcb_poll(void)
+{
+#if AT25DF641_WCB_PAGES
+    int i;
+
+    for (i = 0; i < AT25DF641_WCB_PAGES; i++)
+    {
+        if ((wcb[i].hi > 0) && ((wcb_now - wcb[i].since) >= AT25DF641_WCB_TIMEOUT))
+        {
+            return at25df641_wcb_flush();
+        }
+    }
+#endif
+
+    return OK;
+}
+
+void at25df641_wcb_stats(at25df641_wcb_stats_t *stats)
+{
+    *stats = wcb_stats;
+}
+
+int at25df641_enable_write(at25df641_dev_t dev)
+{
+    int status;
+    /* initialize a new command */
+    CMD(dev) = AT25DF641_OPCODE_WR_EN;
+    CMD_SIZ(dev) = 1;
+    DATA(dev) = NULL;
+    SIZE(dev) = 0;
+    ADDR(dev) = 0;
+
+    status = at25df641_command_handler(dev);
+
+    /* wait til command is executed */
+    if (at25df641_wait_rdy(dev) != OK )
+    {
+        return ERROR_DEFAULT;
+    }
+
+    return status;
+}
+
+int at25df641_read_status(at25df641_dev_t dev, unsigned char *status)
+{
+    /* initialize a new command */
+    CMD(dev) = AT25DF641_OPCODE_RD_SR;
+    CMD_SIZ(dev) = 1;
+    DATA(dev) = status;
+    SIZE(dev) = 1;
+    ADDR(dev) = 0;
+
+    return at25df641_command_handler(dev);
+}
+
+int at25df641_chip_protect(at25df641_dev_t dev, at25df641_prot_t prot_type)
+{
+    unsigned char tmp;
+
+    /* enable critical write operation */
+    if (at25df641_enable_write(dev) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* wait til command is executed */
+    if (at25df641_wait_rdy(dev) != OK )
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* write one byte in the status register */
+    if (prot_type == PROTECT)
+    {
+        if ((at25df641_read_status(dev, &tmp)) != OK)
+        {
+            return ERROR_DEFAULT;
+        }
+
+        /* write the old status with new status in status register */
+        if ((at25df641_write_status(dev, tmp | AT25DF641_GLOBAL_PROTECT_VALUE)) != OK)
+        {
+            return ERROR_DEFAULT;
+        }
+    }
+    else
+    {
+        if ((at25df641_write_status(dev, 0x00)) != OK)
+        {
+            return ERROR_DEFAULT;
+        }
+    }
+
+    /* read the new status register */
+    if ((at25df641_read_status(dev, &tmp)) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* check if the corresponding flag is set or not */
+    if (prot_type == PROTECT)
+    {
+        if ((tmp & AT25DF641_MASK_SR_SWP) == AT25DF641_SR_SWP_NONE)
+        {
+            return ERROR_UNPROTECTED;
+        }
+    }
+    else
+    {
+        if ((tmp & (AT25DF641_MASK_SR_SWP | AT25DF641_MASK_SR_SPRL)) != 0x00)
+        {
+            return ERROR_PROTECTED;
+        }
+    }
+
+    return OK;
+}
+
+int at25df641_write_status(at25df641_dev_t dev, unsigned char data)
+{
+    /* initialize a new command */
+    CMD(dev) = AT25DF641_OPCODE_WR_SR_FRST_BYTE;
+    CMD_SIZ(dev) = 1;
+    DATA(dev) = (unsigned char *) &data; // Byte to write.
+    SIZE(dev) = 1;                       // Write one Byte.
+    ADDR(dev) = 0;                       // No address needed.
+
+    return at25df641_command_handler(dev);
+}
+
+int at25df641_erase_block(at25df641_dev_t dev, uint32_t addr, at25df641_erase_t erase_cmd)
+{
+    unsigned char status;
+
+    if (pe[dev].state != PE_IDLE)
+    {
+        return ERROR_BUSY;
+    }
+
+    at25df641_chip_protect(dev, UNPROTECT);
+
+    /* check if address is out of bounds */
+    if (addr > AT25DF641_MEM_SIZE)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    /* read the status register */
+    if (at25df641_read_status(dev, &status) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* check if device is busy */
+    if ((status & AT25DF641_MASK_SR_RDYBSY) != AT25DF641_SR_RDYBSY_READY)
+    {
+        return ERROR_BUSY;
+    }
+
+    /* check if some sectors are protected */
+    if ((status & AT25DF641_MASK_SR_SWP) != AT25DF641_SR_SWP_NONE)
+    {
+        return ERROR_PROTECTED;
+    }
+
+    /* enable critical write operation */
+    if (at25df641_enable_write(dev) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* initialize a new command */
+    CMD(dev) = erase_cmd; // operation code.
+    CMD_SIZ(dev) = 4;
+    DATA(dev) = NULL;     // No data to transmitt.
+    SIZE(dev) = 1;        // Command size is 1 Byte.
+    ADDR(dev) = addr;     // which address should be erased.
+
+    /* execute command */
+    if (at25df641_command_handler(dev) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* wait til command is executed */
+    if (at25df641_wait_rdy(dev) != OK )
+    {
+        return ERROR_DEFAULT;
+    }
+
+    at25df641_chip_protect(dev, PROTECT);
+
+    return OK;
+}
+
+/**
+ * @brief Unprotects the chip and starts the first step of an operation
+ */
+static int _pe_start(at25df641_dev_t dev, uint8_t cmd, const unsigned char *data,
+                     uint32_t size, uint32_t addr, at25df641_cb_t cb, void *arg)
+{
+    at25df641_pe_t *op = &pe[dev];
+    int status;
+
+    if (op->state != PE_IDLE)
+    {
+        return ERROR_BUSY;
+    }
+
+    if ((status = at25df641_chip_protect(dev, UNPROTECT)) != OK)
+    {
+        return status;
+    }
+
+    op->cmd = cmd;
+    op->data = data;
+    op->size = size;
+    op->addr = addr;
+    op->status = OK;
+    op->cb = cb;
+    op->arg = arg;
+    op->suspended = 0;
+
+    BUS_LOCK();
+    _stream_suspend();
+    _pe_issue(dev);
+    op->state = PE_BUSY;
+    BUS_UNLOCK();
+
+    return OK;
+}
+
+int at25df641_write_async(at25df641_dev_t dev, const unsigned char *data,
+                          uint32_t size, uint32_t addr, at25df641_cb_t cb,
+                          void *arg)
+{
+    if (((size + addr) > AT25DF641_MEM_SIZE) || (size == 0))
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    return _pe_start(dev, AT25DF641_OPCODE_BYTE_PROGR, data, size, addr, cb, arg);
+}
+
+int at25df641_erase_async(at25df641_dev_t dev, uint32_t addr,
+                          at25df641_erase_t erase_cmd, at25df641_cb_t cb,
+                          void *arg)
+{
+    if (addr >= AT25DF641_MEM_SIZE)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    return _pe_start(dev, erase_cmd, NULL, 0, addr, cb, arg);
+}
+
+/**
+ * @brief Starts a queued program or erase, the bus is owned
+ *
+ * The unprotection is written like at25df641_chip_protect(), the first step
+ * follows with the next tick.
+ */
+static void _pe_queue_start(at25df641_trans_t *trans)
+{
+    at25df641_pe_t *op = &pe[trans->dev];
+
+    op->cmd = (trans->type == TRANS_WRITE) ? AT25DF641_OPCODE_BYTE_PROGR : trans->erase_cmd;
+    op->data = trans->data;
+    op->size = (trans->type == TRANS_WRITE) ? trans->size : 0;
+    op->addr = trans->addr;
+    op->status = OK;
+    op->cb = trans->cb;
+    op->arg = trans->arg;
+    op->suspended = 0;
+
+    _raw_command(trans->dev, AT25DF641_OPCODE_WR_EN, 0, 1, NULL, 0);
+    _raw_command(trans->dev, AT25DF641_OPCODE_WR_SR_FRST_BYTE, 0, 2, NULL, 0);
+    op->state = PE_START;
+}
+
+static int _sched(void);
+
+/**
+ * @brief Finishes a queued read and starts the next transactions
+ */
+static void _trans_done(void *arg, int status)
+{
+    at25df641_trans_t *trans = arg;
+
+    if (trans->cb != NULL)
+    {
+        trans->cb(trans->arg, status);
+    }
+
+    /* else the next tick starts them */
+    if (spi_acquire(SPI_0) == 0)
+    {
+        if (!_sched())
+        {
+            BUS_UNLOCK();
+        }
+    }
+}
+
+/**
+ * @brief Starts the queued transactions which can run now, the bus is owned
+ *
+ * The playback read goes first. Then walks the queue in order of priority.
+ * Program and erase start on every chip without a running operation, a
+ * read takes the bus til it is done.
+ *
+ * @return              1 if the bus was handed to a read
+ */
+static int _sched(void)
+{
+    at25df641_trans_t **link = &queue;
+    at25df641_trans_t *trans;
+
+    if ((queue != NULL) || (play != NULL))
+    {
+        _stream_suspend();
+    }
+
+    if ((play != NULL) && !_pe_hit(play->dev, play->addr, play->size))
+    {
+        trans = play;
+        play = NULL;
+        _read_start(trans->dev, trans->addr, trans->size);
+        _read_async_start(trans->dev, trans->data, trans->size, 0, _trans_done, trans);
+        return 1;
+    }
+
+    while ((trans = *link) != NULL)
+    {
+        if (trans->type == TRANS_READ)
+        {
+            /* a read of the sector of a running step waits for its end */
+            if (_pe_hit(trans->dev, trans->addr, trans->size))
+            {
+                link = &trans->next;
+                continue;
+            }
+
+            *link = trans->next;
+            _read_start(trans->dev, trans->addr, trans->size);
+            _read_async_start(trans->dev, trans->data, trans->size, 0, _trans_done, trans);
+            return 1;
+        }
+
+        if (pe[trans->dev].state == PE_IDLE)
+        {
+            *link = trans->next;
+            _pe_queue_start(trans);
+        }
+        else
+        {
+            link = &trans->next;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Takes the playback read, which starts as soon as the bus is free
+ */
+static int _submit_play(at25df641_trans_t *trans)
+{
+    uint32_t primask;
+    int status = ERROR_BUSY;
+
+    if (trans->type != TRANS_READ)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (play == NULL)
+    {
+        play = trans;
+        status = OK;
+    }
+
+    __set_PRIMASK(primask);
+
+    /* else the end of the running read or the tick starts it */
+    if ((status == OK) && (spi_acquire(SPI_0) == 0))
+    {
+        if (!_sched())
+        {
+            BUS_UNLOCK();
+        }
+    }
+
+    return status;
+}
+
+int at25df641_submit(at25df641_trans_t *trans)
+{
+    at25df641_trans_t **link = &queue;
+
+    if (((trans->addr + trans->size) > AT25DF641_MEM_SIZE) ||
+        ((trans->type != TRANS_ERASE) && (trans->size == 0)))
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    /* the playback read never waits for the bus, it may come from interrupts */
+    if (trans->prio == PRIO_PLAYBACK)
+    {
+        return _submit_play(trans);
+    }
+
+    BUS_LOCK();
+
+    /* behind all transactions of the same or a higher priority */
+    while ((*link != NULL) && ((*link)->prio <= trans->prio))
+    {
+        link = &(*link)->next;
+    }
+
+    trans->next = *link;
+    *link = trans;
+
+    if (!_sched())
+    {
+        BUS_UNLOCK();
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Advances the operation of one device, the bus is owned
+ *
+ * @return              1 if the operation is finished, its callback is stored
+ */
+static int _pe_step(at25df641_dev_t dev, at25df641_cb_t *cb, void **arg, int *result)
+{
+    at25df641_pe_t *op = &pe[dev];
+    unsigned char status;
+
+    if (op->state == PE_IDLE)
+    {
+        return 0;
+    }
+
+    /* go on checking, reads between two ticks would suspend it forever */
+    if (op->suspended)
+    {
+        _raw_command(dev, AT25DF641_OPCODE_PROGR_RESUM, 0, 1, NULL, 0);
+        op->suspended = 0;
+    }
+
+    status = _raw_status(dev);
+
+    if ((status & AT25DF641_MASK_SR_RDYBSY) != AT25DF641_SR_RDYBSY_READY)
+    {
+        return 0;
+    }
+
+    if (op->state == PE_START)
+    {
+        _pe_issue(dev);
+        op->state = PE_BUSY;
+        return 0;
+    }
+
+    if (op->state == PE_PROTECT)
+    {
+        *cb = op->cb;
+        *arg = op->arg;
+        *result = op->status;
+        op->state = PE_IDLE;
+        return 1;
+    }
+
+    /* Check if the last step had an error */
+    if ((status & AT25DF641_MASK_SR_EPE) != AT25DF641_SR_EPE_SUCCESS)
+    {
+        op->status = ERROR_WRITE;
+        op->size = 0;
+    }
+
+    if (op->size > 0)
+    {
+        _pe_issue(dev);
+    }
+    else
+    {
+        /* protect the chip again, like the blocking functions */
+        status |= AT25DF641_GLOBAL_PROTECT_VALUE;
+        _raw_command(dev, AT25DF641_OPCODE_WR_EN, 0, 1, NULL, 0);
+        _raw_command(dev, AT25DF641_OPCODE_WR_SR_FRST_BYTE, (uint32_t)status << 16, 2, NULL, 0);
+        op->state = PE_PROTECT;
+    }
+
+    return 0;
+}
+
+void at25df641_tick(void)
+{
+    at25df641_cb_t cb[AT25DF641_NUMOF];
+    void *arg[AT25DF641_NUMOF];
+    int result[AT25DF641_NUMOF];
+    int dev, done = 0;
+
+#if AT25DF641_WCB_PAGES
+    wcb_now++;
+#endif
+
+    /* skip the tick if nothing is to do or a read or a command owns the bus */
+    if ((!at25df641_pe_busy() && (queue == NULL) && (play == NULL)) || (spi_acquire(SPI_0) != 0))
+    {
+        return;
+    }
+
+    /* the stream restarts its command with the next read */
+    _stream_suspend();
+
+    for (dev = 0; dev < AT25DF641_NUMOF; dev++)
+    {
+        if (_pe_step(dev, &cb[dev], &arg[dev], &result[dev]))
+        {
+            done |= (1 << dev);
+        }
+    }
+
+    /* finished chips take the next queued operation */
+    if (!_sched())
+    {
+        BUS_UNLOCK();
+    }
+
+    for (dev = 0; dev < AT25DF641_NUMOF; dev++)
+    {
+        if ((done & (1 << dev)) && (cb[dev] != NULL))
+        {
+            cb[dev](arg[dev], result[dev]);
+        }
+    }
+}
+
+int at25df641_pe_busy(void)
+{
+    int dev;
+
+    for (dev = 0; dev < AT25DF641_NUMOF; dev++)
+    {
+        if (pe[dev].state != PE_IDLE)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int at25df641_wait_rdy(at25df641_dev_t dev)
+{
+    unsigned char status;
+    unsigned char ready = 0;
+
+    /* polling the status register to check busy bit */
+    while (!ready)
+    {
+        if (at25df641_read_status(dev, &status) != OK)
+        {
+            return ERROR_DEFAULT;
+        }
+
+        if ((status & AT25DF641_MASK_SR_RDYBSY) == AT25DF641_SR_RDYBSY_READY)
+        {
+        ready = 1;
+        }
+    }
+
+    return OK;
+}
+
+int at25df641_compare(at25df641_dev_t fir, at25df641_dev_t sec, uint16_t size, uint32_t address)
+{
+    int i, counter = 0;
+    unsigned char work_buf[AT25DF641_PAGE_SIZE];
+    unsigned char orig_buf[AT25DF641_PAGE_SIZE];
+
+    size = MINIMUM(size, AT25DF641_PAGE_SIZE);
+
+    _read_array(fir, work_buf, size, address);
+    _read_array(sec, orig_buf, size, address);
+
+    for (i = 0; i < size; i++)
+    {
+        if (work_buf[i] != orig_buf[i])
+        {
+            counter++;
+        }
+    }
+
+    return counter;
+}
+
+/**
+ * @brief Callback of the verification reads
+ */
+static void _verify_read_done(void *arg, int status)
+{
+    int n = (int)(intptr_t)arg;
+
+    verify_status[n] = status;
+    verify_done[n] = 1;
+}
+
+/**
+ * @brief Starts a verification read into verify_buf[n]
+ */
+static int _verify_read(at25df641_dev_t dev, int n, uint32_t size, uint32_t addr)
+{
+    int status;
+
+    verify_done[n] = 0;
+
+    /* the bus may be used by the read-ahead for a moment */
+    while ((status = at25df641_read_async(dev, (unsigned char *)verify_buf[n], size, addr,
+                                          _verify_read_done, (void *)(intptr_t)n)) == ERROR_BUSY);
+
+    return status;
+}
+
+/**
+ * @brief Waits for a verification read
+ */
+static int _verify_wait(int n)
+{
+    while (!verify_done[n]);
+
+    return verify_status[n];
+}
+
+/**
+ * @brief Adds one different byte to the ranges, neighbours are merged
+ */
+static void _verify_add(at25df641_range_t *ranges, int max, int *count, uint32_t addr)
+{
+    if ((*count > 0) && ((ranges[*count - 1].addr + ranges[*count - 1].size) == addr))
+    {
+        ranges[*count - 1].size++;
+    }
+    else if (*count < max)
+    {
+        ranges[*count].addr = addr;
+        ranges[*count].size = 1;
+        (*count)++;
+    }
+}
+
+int at25df641_verify(at25df641_dev_t fir, at25df641_dev_t sec, uint32_t addr,
+                     uint32_t size, at25df641_range_t *ranges, int max,
+                     int *count)
+{
+    const unsigned char *a = (const unsigned char *)verify_buf[0];
+    const unsigned char *b = (const unsigned char *)verify_buf[1];
+    uint32_t chunk, i, crc;
+    int status, counter = 0;
+    int stored = 0;
+
+    if ((size + addr) > AT25DF641_MEM_SIZE)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    crc_init();
+
+    while (size > 0)
+    {
+        chunk = MINIMUM(size, VERIFY_BLOCK);
+
+        if (((status = _verify_read(fir, 0, chunk, addr)) != OK) || ((status = _verify_wait(0)) != OK))
+        {
+            return status;
+        }
+
+        /* the CRC of the first chip is calculated while the second is read */
+        if ((status = _verify_read(sec, 1, chunk, addr)) != OK)
+        {
+            return status;
+        }
+
+        crc = crc_calc(a, chunk);
+
+        if ((status = _verify_wait(1)) != OK)
+        {
+            return status;
+        }
+
+        /* search the different bytes only in blocks with different CRCs */
+        if (crc != crc_calc(b, chunk))
+        {
+            for (i = 0; i < chunk; i++)
+            {
+                if (a[i] != b[i])
+                {
+                    counter++;
+
+                    if (ranges != NULL)
+                    {
+                        _verify_add(ranges, max, &stored, addr + i);
+                    }
+                }
+            }
+        }
+
+        addr += chunk;
+        size -= chunk;
+    }
+
+    if (count != NULL)
+    {
+        *count = stored;
+    }
+
+    return counter;
+}
+
+int at25df641_chip_erase(at25df641_dev_t dev)
+{
+    if (pe[dev].state != PE_IDLE)
+    {
+        return ERROR_BUSY;
+    }
+
+    at25df641_chip_protect(dev, UNPROTECT);
+
+    /* enable critical write operation */
+    if (at25df641_enable_write(dev) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* wait til command is executed */
+    if (at25df641_wait_rdy(dev) != OK )
+    {
+        return ERROR_DEFAULT;
+    }
+
+    CMD(dev) = AT25DF641_OPCODE_CHIP_ERASE;
+    CMD_SIZ(dev) = 1;
+    DATA(dev) = NULL;
+    SIZE(dev) = 0;
+    ADDR(dev) = 0;
+
+    /* execute command */
+    if (at25df641_command_handler(dev) != OK)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    /* wait til command is executed */
+    if (at25df641_wait_rdy(dev) != OK )
+    {
+        return ERROR_DEFAULT;
+    }
+
+    at25df641_chip_protect(dev, PROTECT);
+
+    return OK;
+}
+
+/**
+ * @brief Checks if the bytes of src can only be programmed after an erase
+ *
+ * Programming can only clear bits, so every bit set in src has to be set
+ * in dst.
+ */
+static int _needs_erase(const unsigned char *src, const unsigned char *dst, uint32_t size)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        if ((src[i] & dst[i]) != src[i])
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Checks if a page only holds erased bytes
+ */
+static int _is_blank(const unsigned char *data, uint32_t size)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        if (data[i] != 0xFF)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Programs the pages of a sector which differ
+ *
+ * @param[in] *old      old content of the sector, NULL if it is erased
+ */
+static int _sync_program(at25df641_dev_t dst, uint32_t addr, unsigned char *src,
+                         const unsigned char *old, at25df641_sync_t *stats)
+{
+    int page, start = -1;
+    int status, differ;
+
+    for (page = 0; page <= (VERIFY_BLOCK / AT25DF641_PAGE_SIZE); page++)
+    {
+        differ = 0;
+
+        if (page < (VERIFY_BLOCK / AT25DF641_PAGE_SIZE))
+        {
+            if (old == NULL)
+            {
+                differ = !_is_blank(&src[page * AT25DF641_PAGE_SIZE], AT25DF641_PAGE_SIZE);
+            }
+            else
+            {
+                differ = (memcmp(&src[page * AT25DF641_PAGE_SIZE], &old[page * AT25DF641_PAGE_SIZE],
+                                 AT25DF641_PAGE_SIZE) != 0);
+            }
+        }
+
+        /* program runs of pages with one call */
+        if (differ && (start < 0))
+        {
+            start = page;
+        }
+        else if (!differ && (start >= 0))
+        {
+            status = at25df641_write(dst, &src[start * AT25DF641_PAGE_SIZE],
+                                     (page - start) * AT25DF641_PAGE_SIZE,
+                                     addr + start * AT25DF641_PAGE_SIZE);
+            if (status != OK)
+            {
+                return status;
+            }
+
+            if (stats != NULL)
+            {
+                stats->pages_written += page - start;
+            }
+
+            start = -1;
+        }
+    }
+
+    return OK;
+}
+
+int at25df641_sync(at25df641_dev_t dst, at25df641_dev_t src, at25df641_sync_t *stats)
+{
+    return at25df641_sync_range(dst, src, 0, AT25DF641_MEM_SIZE, stats);
+}
+
+int at25df641_sync_range(at25df641_dev_t dst, at25df641_dev_t src, uint32_t start,
+                         uint32_t len, at25df641_sync_t *stats)
+{
+    const int sectors = AT25DF641_BLOCK_SIZE / VERIFY_BLOCK;
+    unsigned char *src_buf = (unsigned char *)verify_buf[0];
+    unsigned char *dst_buf = (unsigned char *)verify_buf[1];
+    uint32_t block, addr, end;
+    uint32_t crc;
+    uint16_t diff, erase;
+    int i, status;
+
+    if ((start >= AT25DF641_MEM_SIZE) || (len > (AT25DF641_MEM_SIZE - start)))
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    /* whole blocks around the range */
+    end = start + len;
+    start -= start % AT25DF641_BLOCK_SIZE;
+
+    crc_init();
+
+    for (block = start; block < end; block += AT25DF641_BLOCK_SIZE)
+    {
+        /* checksums of all sectors of the block, the CRC of src is
+         * calculated while dst is read */
+        diff = 0;
+        for (i = 0; i < sectors; i++)
+        {
+            addr = block + i * VERIFY_BLOCK;
+
+            if (((status = _verify_read(src, 0, VERIFY_BLOCK, addr)) != OK) ||
+                ((status = _verify_wait(0)) != OK) ||
+                ((status = _verify_read(dst, 1, VERIFY_BLOCK, addr)) != OK))
+            {
+                return status;
+            }
+
+            crc = crc_calc(src_buf, VERIFY_BLOCK);
+
+            if ((status = _verify_wait(1)) != OK)
+            {
+                return status;
+            }
+
+            if (crc != crc_calc(dst_buf, VERIFY_BLOCK))
+            {
+                diff |= (1 << i);
+            }
+        }
+
+        if (diff == 0)
+        {
+            if (stats != NULL)
+            {
+                stats->blocks_same++;
+            }
+
+            continue;
+        }
+
+        /* find the sectors which can not be programmed over */
+        erase = 0;
+        for (i = 0; i < sectors; i++)
+        {
+            addr = block + i * VERIFY_BLOCK;
+
+            if (diff & (1 << i))
+            {
+                if (((status = at25df641_read(src, src_buf, VERIFY_BLOCK, addr)) != OK) ||
+                    ((status = at25df641_read(dst, dst_buf, VERIFY_BLOCK, addr)) != OK))
+                {
+                    return status;
+                }
+
+                if (_needs_erase(src_buf, dst_buf, VERIFY_BLOCK))
+                {
+                    erase |= (1 << i);
+                }
+            }
+        }
+
+        /* erase with as few commands as possible */
+        if (erase == (uint16_t)((1 << sectors) - 1))
+        {
+            if ((status = at25df641_erase_block(dst, block, BLOCK_ERASE_64KB)) != OK)
+            {
+                return status;
+            }
+        }
+        else
+        {
+            for (i = 0; i < sectors; i++)
+            {
+                if ((erase & (1 << i)) &&
+                    ((status = at25df641_erase_block(dst, block + i * VERIFY_BLOCK, BLOCK_ERASE_4KB)) != OK))
+                {
+                    return status;
+                }
+            }
+        }
+
+        if (stats != NULL)
+        {
+            for (i = 0; i < sectors; i++)
+            {
+                stats->sectors_erased += (erase >> i) & 1;
+            }
+        }
+
+        /* program the differences */
+        for (i = 0; i < sectors; i++)
+        {
+            addr = block + i * VERIFY_BLOCK;
+
+            if (!(diff & (1 << i)))
+            {
+                continue;
+            }
+
+            if ((status = at25df641_read(src, src_buf, VERIFY_BLOCK, addr)) != OK)
+            {
+                return status;
+            }
+
+            if (!(erase & (1 << i)) &&
+                ((status = at25df641_read(dst, dst_buf, VERIFY_BLOCK, addr)) != OK))
+            {
+                return status;
+            }
+
+            if ((status = _sync_program(dst, addr, src_buf, (erase & (1 << i)) ? NULL : dst_buf, stats)) != OK)
+            {
+                return status;
+            }
+        }
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Finds the sectors of a 64KB block which hold data
+ *
+ * The blank check of a sector runs while the next one is read.
+ *
+ * @param[in] block     address of the block
+ * @param[in] first     first sector of the block to check
+ * @param[in] last      last sector of the block to check
+ * @param[out] *used    mask of the sectors which are not blank
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+static int _blank_check(at25df641_dev_t dev, uint32_t block, int first, int last, uint16_t *used)
+{
+    int i, status;
+
+    *used = 0;
+
+    /* no read may be left running behind an empty range */
+    if (first > last)
+    {
+        return OK;
+    }
+
+    if ((status = _verify_read(dev, first & 1, VERIFY_BLOCK, block + first * VERIFY_BLOCK)) != OK)
+    {
+        return status;
+    }
+
+    for (i = first; i <= last; i++)
+    {
+        if ((status = _verify_wait(i & 1)) != OK)
+        {
+            return status;
+        }
+
+        if ((i < last) &&
+            ((status = _verify_read(dev, (i + 1) & 1, VERIFY_BLOCK, block + (i + 1) * VERIFY_BLOCK)) != OK))
+        {
+            return status;
+        }
+
+        if (!_is_blank((const unsigned char *)verify_buf[i & 1], VERIFY_BLOCK))
+        {
+            *used |= (1 << i);
+        }
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Counts the set bits of a sector mask
+ */
+static int _sector_count(uint16_t mask)
+{
+    int n = 0;
+
+    while (mask)
+    {
+        n += mask & 1;
+        mask >>= 1;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Erases the used sectors of one half (32KB) of a block
+ *
+ * @param[in] whole     flag if the whole half is inside the erased range
+ */
+static int _erase_half(at25df641_dev_t dev, uint32_t addr, uint16_t used, int whole, int *commands)
+{
+    const int sectors = AT25DF641_BLOCK_SIZE / VERIFY_BLOCK / 2;
+    int i, status;
+
+    if (used == 0)
+    {
+        return OK;
+    }
+
+    if (whole && (ERASE_TIME_32KB < (ERASE_TIME_4KB * _sector_count(used))))
+    {
+        (*commands)++;
+        return at25df641_erase_block(dev, addr, BLOCK_ERASE_32KB);
+    }
+
+    for (i = 0; i < sectors; i++)
+    {
+        if (used & (1 << i))
+        {
+            (*commands)++;
+
+            if ((status = at25df641_erase_block(dev, addr + i * VERIFY_BLOCK, BLOCK_ERASE_4KB)) != OK)
+            {
+                return status;
+            }
+        }
+    }
+
+    return OK;
+}
+
+int at25df641_erase_range(at25df641_dev_t dev, uint32_t addr, uint32_t len)
+{
+    const int sectors = AT25DF641_BLOCK_SIZE / VERIFY_BLOCK;
+    const int half = sectors / 2;
+    uint32_t block, end = addr + len;
+    uint16_t used, in_range, mask;
+    int first, last, status;
+    int commands = 0;
+    int cost_half, cost, h;
+
+    if ((end > AT25DF641_MEM_SIZE) || (end < addr))
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    /* erasing can not stop inside of a sector */
+    if ((addr % VERIFY_BLOCK) || (len % VERIFY_BLOCK))
+    {
+        return ERROR_DEFAULT;
+    }
+
+    if (len == 0)
+    {
+        return OK;
+    }
+
+    crc_init();
+
+    for (block = addr - (addr % AT25DF641_BLOCK_SIZE); block < end; block += AT25DF641_BLOCK_SIZE)
+    {
+        /* sectors of the block inside of the range */
+        first = (block < addr) ? ((addr - block) / VERIFY_BLOCK) : 0;
+        last = ((block + AT25DF641_BLOCK_SIZE) > end) ? (((end - block) / VERIFY_BLOCK) - 1) : (sectors - 1);
+        in_range = (uint16_t)(((1 << (last + 1)) - 1) & ~((1 << first) - 1));
+
+        if ((status = _blank_check(dev, block, first, last, &used)) != OK)
+        {
+            return status;
+        }
+
+        if (used == 0)
+        {
+            continue;
+        }
+
+        /* cost of the best erase of each half against one 64KB erase */
+        cost_half = 0;
+        for (h = 0; h < 2; h++)
+        {
+            mask = (used >> (h * half)) & ((1 << half) - 1);
+            cost = _sector_count(mask) * ERASE_TIME_4KB;
+
+            if ((((in_range >> (h * half)) & ((1 << half) - 1)) == ((1 << half) - 1)) &&
+                (ERASE_TIME_32KB < cost))
+            {
+                cost = ERASE_TIME_32KB;
+            }
+
+            cost_half += cost;
+        }
+
+        if ((in_range == (uint16_t)((1 << sectors) - 1)) && (ERASE_TIME_64KB < cost_half))
+        {
+            commands++;
+
+            if ((status = at25df641_erase_block(dev, block, BLOCK_ERASE_64KB)) != OK)
+            {
+                return status;
+            }
+
+            continue;
+        }
+
+        for (h = 0; h < 2; h++)
+        {
+            status = _erase_half(dev, block + h * (AT25DF641_BLOCK_SIZE / 2),
+                                 (used >> (h * half)) & ((1 << half) - 1),
+                                 ((in_range >> (h * half)) & ((1 << half) - 1)) == ((1 << half) - 1),
+                                 &commands);
+            if (status != OK)
+            {
+                return status;
+            }
+        }
+    }
+
+    return commands;
+}
+
+int at25df641_copy_all(void)
+{
+    return at25df641_sync(AT25DF641_0, AT25DF641_1, NULL);
+}
+
+int at25df641_compare_all(void)
+{
+    return at25df641_verify(AT25DF641_0, AT25DF641_1, 0, AT25DF641_MEM_SIZE, NULL, 0, NULL);
+}
@@ -0,0 +1,257 @@
+/**
+ * @{
+ *
+ * @brief     Throughput measurements of the application components
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stm32f4xx.h>
+
+#include "include/bench.h"
+#include "include/fsmc.h"
+#define ARM_ADS
+#include "include/mp3dec.h"
+#include "driver/at25df641.h"
+#include "driver/config/periph_conf.h"
+#include "driver/define/at25df641_def.h"
+
+/** Number of bytes read per measurement */
+#define BENCH_SIZE      (64 * 1024)
+/** Number of bytes read per call */
+#define BENCH_CHUNK     (2048)
+/** Number of bytes appended per measurement */
+#define BENCH_APPEND    (16 * 1024)
+/** Number of bytes appended per call, like a log record */
+#define BENCH_RECORD    (32)
+/** Number of words per FSMC block, one output frame */
+#define BENCH_FSMC_WORDS (2304)
+/** Number of FSMC blocks per measurement */
+#define BENCH_FSMC_LOOPS (64)
+/** Number of MP3 bytes decoded per measurement */
+#define BENCH_MP3_SIZE  (16 * 1024)
+
+/** Read buffer, not on stack for DMA */
+static unsigned char buf[BENCH_CHUNK];
+
+void bench_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t bench_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+void bench_report(const char *name, uint32_t bytes, uint32_t cycles,
+                  uint32_t wire_hz)
+{
+    uint32_t bps = (uint32_t)(((uint64_t)bytes * SYS_FREQ) / cycles);
+    uint32_t wire = wire_hz / 8;
+
+    if (wire > 0)
+    {
+        printf("%s: %u B/s (%u%% of %u B/s wire speed)\n", name, bps,
+               (uint32_t)(((uint64_t)bps * 100) / wire), wire);
+    }
+    else
+    {
+        printf("%s: %u B/s\n", name, bps);
+    }
+}
+
+uint32_t bench_load(uint64_t cycles, uint32_t samples, uint32_t rate)
+{
+    if (samples == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)((cycles * rate * 1000) / ((uint64_t)samples * SYS_FREQ));
+}
+
+void bench_report_load(const char *name, uint64_t cycles, uint32_t samples,
+                       uint32_t rate)
+{
+    uint32_t load = bench_load(cycles, samples, rate);
+
+    if (samples == 0)
+    {
+        return;
+    }
+
+    printf("%s: %u cycles per second of audio (%u.%u%% cpu)\n", name,
+           (uint32_t)((cycles * rate) / samples), load / 10, load % 10);
+}
+
+void bench_flash_read(at25df641_dev_t dev, uint32_t wire_hz)
+{
+    static const char *mode_name[] = {
+        "at25df641_read (0x03)",
+        "at25df641_read (0x0B)",
+        "at25df641_read (0x1B)",
+    };
+    uint32_t addr, start;
+    int mode;
+
+    /* compare all read commands */
+    for (mode = READ_LOW_FREQ; mode <= READ_MAX_FREQ; mode++)
+    {
+        at25df641_set_read_mode(dev, (at25df641_read_t)mode);
+
+        start = bench_cycles();
+        for (addr = 0; addr < BENCH_SIZE; addr += BENCH_CHUNK)
+        {
+            at25df641_read(dev, buf, BENCH_CHUNK, addr);
+        }
+        bench_report(mode_name[mode], BENCH_SIZE, bench_cycles() - start, wire_hz);
+    }
+
+    at25df641_set_read_mode(dev, READ_FAST);
+
+    start = bench_cycles();
+    for (addr = 0; addr < BENCH_SIZE; addr += BENCH_CHUNK)
+    {
+        at25df641_read_async(dev, buf, BENCH_CHUNK, addr, NULL, NULL);
+        while (at25df641_async_busy());
+    }
+    bench_report("at25df641_read_async", BENCH_SIZE, bench_cycles() - start, wire_hz);
+}
+
+void bench_flash_verify(uint32_t wire_hz)
+{
+    uint32_t addr, start;
+
+    /* both chips are read, so the wire carries twice the compared bytes */
+    start = bench_cycles();
+    for (addr = 0; addr < BENCH_SIZE; addr += AT25DF641_PAGE_SIZE)
+    {
+        at25df641_compare(AT25DF641_0, AT25DF641_1, AT25DF641_PAGE_SIZE, addr);
+    }
+    bench_report("at25df641_compare", BENCH_SIZE, bench_cycles() - start, wire_hz / 2);
+
+    start = bench_cycles();
+    at25df641_verify(AT25DF641_0, AT25DF641_1, 0, BENCH_SIZE, NULL, 0, NULL);
+    bench_report("at25df641_verify", BENCH_SIZE, bench_cycles() - start, wire_hz / 2);
+}
+
+void bench_flash_append(at25df641_dev_t dev, uint32_t addr)
+{
+    at25df641_wcb_stats_t before, after;
+    uint32_t i, start;
+
+    for (i = 0; i < BENCH_CHUNK; i++)
+    {
+        buf[i] = (unsigned char)(i * 7);
+    }
+
+    /* every call (un)protects the chip and programs a part of a page */
+    at25df641_erase_block(dev, addr, BLOCK_ERASE_64KB);
+    start = bench_cycles();
+    for (i = 0; i < BENCH_APPEND; i += BENCH_RECORD)
+    {
+        at25df641_write(dev, &buf[i % BENCH_CHUNK], BENCH_RECORD, addr + i);
+    }
+    bench_report("at25df641_write (32 byte)", BENCH_APPEND, bench_cycles() - start, 0);
+
+    at25df641_erase_block(dev, addr, BLOCK_ERASE_64KB);
+    at25df641_wcb_stats(&before);
+    start = bench_cycles();
+    for (i = 0; i < BENCH_APPEND; i += BENCH_RECORD)
+    {
+        at25df641_wcb_write(dev, &buf[i % BENCH_CHUNK], BENCH_RECORD, addr + i);
+    }
+    at25df641_wcb_flush();
+    bench_report("at25df641_wcb_write (32 byte)", BENCH_APPEND, bench_cycles() - start, 0);
+
+    at25df641_wcb_stats(&after);
+    printf("at25df641_wcb_write: %u batches, %u pages\n", after.batches - before.batches,
+           after.pages - before.pages);
+}
+
+void bench_fsmc(uint32_t clk_hz)
+{
+    static int16_t words[BENCH_FSMC_WORDS];
+    uint32_t i, start;
+
+    start = bench_cycles();
+    for (i = 0; i < BENCH_FSMC_LOOPS; i++)
+    {
+        fsmc_transfer_block(words, BENCH_FSMC_WORDS);
+    }
+
+    /* 16 bit per clock, the bus carries every word twice */
+    bench_report("fsmc_transfer_block", BENCH_FSMC_LOOPS * BENCH_FSMC_WORDS * sizeof(int16_t),
+                 bench_cycles() - start, clk_hz * 16 / 2);
+}
+
+void bench_mp3_decode(at25df641_dev_t dev, uint32_t addr, uint32_t len)
+{
+    static unsigned char mp3[BENCH_MP3_SIZE];
+    static short pcm[MAX_NCHAN * MAX_NGRAN * MAX_NSAMP];
+    HMP3Decoder dec;
+    unsigned char *ptr = mp3;
+    uint64_t cycles = 0;
+    uint32_t frames = 0, start, elapsed;
+    int left, offset, status;
+
+    len = MINIMUM(len, BENCH_MP3_SIZE);
+
+    if ((at25df641_read(dev, mp3, len, addr) != OK) || ((dec = MP3InitDecoder()) == 0))
+    {
+        printf("bench_mp3_decode() [ FAIL ]\n");
+        return;
+    }
+
+    left = (int)len;
+
+    while ((offset = MP3FindSyncWord(ptr, left)) >= 0)
+    {
+        ptr += offset;
+        left -= offset;
+
+        start = bench_cycles();
+        status = MP3Decode(dec, &ptr, &left, pcm, 0);
+        elapsed = bench_cycles() - start;
+
+        /* the last frame is cut by the end of the buffer */
+        if (status == ERR_MP3_INDATA_UNDERFLOW)
+        {
+            break;
+        }
+
+        /* a frame without its bit reservoir is skipped, not decoded */
+        if (status == ERR_MP3_MAINDATA_UNDERFLOW)
+        {
+            continue;
+        }
+
+        if (status != ERR_MP3_NONE)
+        {
+            ptr++;
+            left--;
+            continue;
+        }
+
+        cycles += elapsed;
+        frames++;
+    }
+
+    MP3FreeDecoder(dec);
+
+    if ((frames == 0) || (cycles == 0))
+    {
+        printf("MP3Decode: no frames\n");
+        return;
+    }
+
+    printf("MP3Decode: %u frames, %u cycles/frame, %u frames/s\n", frames,
+           (uint32_t)(cycles / frames), (uint32_t)(((uint64_t)frames * SYS_FREQ) / cycles));
+}
@@ -0,0 +1,52 @@
+/**
+ * @{
+ *
+ * @brief     Low-level peripheral driver for CRC.
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <stm32f4xx.h>
+
+#include "driver/crc.h"
+
+void crc_init(void)
+{
+    CRC_CLKEN();
+    CRC_DEV->CR = CRC_CR_RESET;
+}
+
+uint32_t crc_update(const void *data, uint32_t len)
+{
+    const uint32_t *word = (const uint32_t *)data;
+    uint32_t tail = 0;
+    uint32_t i;
+
+    for (i = 0; i < (len / 4); i++)
+    {
+        CRC_DEV->DR = word[i];
+    }
+
+    /* pad the last bytes to a whole word */
+    if (len % 4)
+    {
+        for (i = 0; i < (len % 4); i++)
+        {
+            tail |= (uint32_t)((const uint8_t *)&word[len / 4])[i] << (8 * i);
+        }
+
+        CRC_DEV->DR = tail;
+    }
+
+    return CRC_DEV->DR;
+}
+
+uint32_t crc_calc(const void *data, uint32_t len)
+{
+    CRC_DEV->CR = CRC_CR_RESET;
+
+    return crc_update(data, len);
+}
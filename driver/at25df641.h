@@ -1,224 +1,646 @@
-/**
- * @{
- *
- * @brief     Low-level peripherial device driver interface for AT25Df641.
- * @author    Copyright (C) Rene Herthel <rene-herthel@outlook.de>
- * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
- *
- * @}
- */
-
-#ifndef AT25DF641_H
-#define AT25DF641_H
-
-#include <stm32f4xx.h>
-#include "config/periph_conf.h"
-
-/**
- * @brief Default type definiton for a AT25DF641 memory device
- */
-typedef enum {
-#if AT25DF641_0_EN
-	  AT25DF641_0 = 0,    /**< work */
-#endif
-#if AT25DF641_1_EN
-	  AT25DF641_1         /**< orig */
-#endif
-} at25df641_dev_t;
-
-/**
- * @brief Default type defintion for the data of a AT25DF641
- */
-typedef struct {
-    unsigned char *data;/**< data buffer to be sent or received */
-    uint32_t address;   /**< serialflash internal address */
-    uint16_t data_size; /**< Number of bytes to send/receive */
-    uint8_t cmd;        /**< command byte opcode */
-    uint8_t cmd_size;   /**< number of cmd + addr bytes */
-    GPIO_TypeDef *port; /**< port of the current CS pin */
-    uint8_t pin;        /**< pin number of the current CS pin */
-} at25df641_t;
-
-/**
- * @brief Erase Opcodes default type defintion
- */
-typedef enum {
-    BLOCK_ERASE_4KB  = (0x20),  /**< OPcode for erasing  4 KiloByte */
-    BLOCK_ERASE_32KB = (0x52),  /**< OPcode for erasing 32 KiloByte */
-    BLOCK_ERASE_64KB = (0xD8)   /**< OPcode for erasing 64 KiloByte */
-} at25df641_erase_t;
-
-/**
- * @brief Chip protect default type defintion
- */
-typedef enum {
-    UNPROTECT = 0,
-    PROTECT   = 1,
-} at25df641_prot_t;
-
-/**
- * @brief Initialize an AT25DF641 module
- *
- * @param[in] dev       device descriptor
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_init(at25df641_dev_t dev);
-
-/**
- * @brief Sends a command via SPI
- *
- * @param[in] dev       device descriptor
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_command_handler(at25df641_dev_t dev);
-
-/**
- * @brief Write data with given length to the spi bus
- */
-void write_spi(int length, unsigned char *data);
-
-/**
- * @brief Read data with given length from the spi bus
- */
-void read_spi(int length, unsigned char *data);
-
-/**
- * @brief Write one block with 256 byte into the flash
- *
- * @param[in] dev       device descriptor
- * @param[in] *data     data buffer
- * @param[in] size      number of bytes in buffer
- * @param[in] addr      write address
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_write(at25df641_dev_t dev, unsigned char *data, uint16_t size,
-	                  uint32_t addr);
-
-/**
- * @brief Gives write permissions
- *
- * @param[in] dev       device descriptor
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_enable_write(at25df641_dev_t dev);
-
-/**
- * @brief Read one block with multiple Bytes from flash
- *
- * @param[in] dev       device descriptor
- * @param[out] *data    readed data from memory
- * @param[in] size      number of bytes needed to read from memory
- * @param[in] address   address from where to read
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_read(at25df641_dev_t dev, unsigned char *data, uint16_t size,
-	                 uint32_t addr);
-
-/**
- * @brief Reads the status register from flash and returns it
- *
- * @param[in] dev       device descriptor
- * @param[out] *status  returns one byte from status register
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_read_status(at25df641_dev_t dev, unsigned char *status);
-
-/**
- * @brief Checks the ID of the chip device
- *
- * @param[in] dev       device descriptor
- * @param[out] *dev_id  returns the device ID
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_read_id(at25df641_dev_t dev_id, uint32_t *id_val);
-
-/**
- * @brief Checks the ID of the chip device
- *
- * @param[in] dev       device descriptor
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_check_id(at25df641_dev_t dev);
-
-/**
- * @brief Reads the status register til the RDY/BSY-Bit is cleared
- *
- * @param[in] dev       device descriptor
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_wait_rdy(at25df641_dev_t dev);
-
-/**
- * @brief Clear memory protection flag
- *
- * @param[in] dev       device descriptor
- * @param[in] prot_type en-,disables chip-protection
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_chip_protect(at25df641_dev_t dev,  at25df641_prot_t prot_type);
-
-/**
- * @brief Writes one byte into the status register
- *
- * @param[in] dev       device descriptor
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_write_status(at25df641_dev_t dev, unsigned char data);
-
-/**
- * @brief Erase one block from flash.
- *
- * @param[in] dev       device descriptor
- * @param[in] addr      address of the block which should be erased
- * @param[in] erase_cmd erase command with different size
- *
- * @return               0 on success
- * @return              ERROR_x on error (see defines)
- */
-int at25df641_erase_block(at25df641_dev_t dev, uint32_t addr,
-	                        at25df641_erase_t erase_cmd);
-
-/**
- * @brief Compares a specific address length
- */
-int at25df641_compare(at25df641_dev_t fir, at25df641_dev_t sec,
-	                    uint16_t size, uint32_t address);
-
-/**
- * @brief Erase the whole chip
- */
-int at25df641_chip_erase(at25df641_dev_t dev);
-
-/**
- * @brief Compares both memory devices
- */
-int at25df641_compare_all(void);
-
-/**
- * @brief Copies the whole content from one to another memory device
- */
-int at25df641_copy_all(void);
-
-#endif /* AT25DF641_H */
+/**
+ * @{
+ *
+ * @brief     Low-level peripherial device driver interface for AT25Df641.
+ * @author    Copyright (C) Rene Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef AT25DF641_H
+#define AT25DF641_H
+
+#include <stm32f4xx.h>
+#include "config/periph_conf.h"
+
+/**
+ * @brief Default type definiton for a AT25DF641 memory device
+ */
+typedef enum {
+#if AT25DF641_0_EN
+	  AT25DF641_0 = 0,    /**< work */
+#endif
+#if AT25DF641_1_EN
+	  AT25DF641_1         /**< orig */
+#endif
+} at25df641_dev_t;
+
+/**
+ * @brief Read array modes of the device
+ */
+typedef enum {
+    READ_LOW_FREQ = 0,  /**< 0x03, no dummy byte, SPI clock up to 50MHz */
+    READ_FAST     = 1,  /**< 0x0B, one dummy byte, SPI clock up to 85MHz */
+    READ_MAX_FREQ = 2   /**< 0x1B, two dummy bytes, SPI clock up to 100MHz */
+} at25df641_read_t;
+
+/**
+ * @brief Default type defintion for the data of a AT25DF641
+ */
+typedef struct {
+    unsigned char *data;/**< data buffer to be sent or received */
+    uint32_t address;   /**< serialflash internal address */
+    uint32_t data_size; /**< Number of bytes to send/receive */
+    uint8_t cmd;        /**< command byte opcode */
+    uint8_t cmd_size;   /**< number of cmd + addr bytes */
+    GPIO_TypeDef *port; /**< port of the current CS pin */
+    uint8_t pin;        /**< pin number of the current CS pin */
+    at25df641_read_t read_mode; /**< read command used for the data array */
+    uint32_t stream_addr;   /**< next address of the read stream */
+    uint8_t stream_open;    /**< flag if a read stream is opened */
+    uint8_t stream_active;  /**< not 0 if the stream holds CS asserted */
+} at25df641_t;
+
+/**
+ * @brief Callback type for finished asynchronous operations
+ *
+ * @param[in] *arg      argument given when the operation was started
+ * @param[in] status    0 on success, ERROR_x on error (see defines)
+ */
+typedef void (*at25df641_cb_t)(void *arg, int status);
+
+/**
+ * @brief Range of different bytes found by at25df641_verify()
+ */
+typedef struct {
+    uint32_t addr;      /**< address of the first different byte */
+    uint32_t size;      /**< number of different bytes in a row */
+} at25df641_range_t;
+
+/**
+ * @brief Statistics of at25df641_sync()
+ */
+typedef struct {
+    uint32_t blocks_same;     /**< 64KB blocks which were equal */
+    uint32_t sectors_erased;  /**< 4KB sectors which were erased */
+    uint32_t pages_written;   /**< pages which were programmed */
+} at25df641_sync_t;
+
+/**
+ * @brief Counters of the read cache
+ */
+typedef struct {
+    uint32_t hits;      /**< pages which were copied from the cache */
+    uint32_t misses;    /**< pages which were read from the chip */
+} at25df641_cache_stats_t;
+
+/**
+ * @brief Counters of the write-combining buffer
+ */
+typedef struct {
+    uint32_t writes;    /**< calls of at25df641_wcb_write() */
+    uint32_t batches;   /**< flushes, each (un)protects a chip once */
+    uint32_t pages;     /**< page program commands */
+} at25df641_wcb_stats_t;
+
+/**
+ * @brief Erase Opcodes default type defintion
+ */
+typedef enum {
+    BLOCK_ERASE_4KB  = (0x20),  /**< OPcode for erasing  4 KiloByte */
+    BLOCK_ERASE_32KB = (0x52),  /**< OPcode for erasing 32 KiloByte */
+    BLOCK_ERASE_64KB = (0xD8)   /**< OPcode for erasing 64 KiloByte */
+} at25df641_erase_t;
+
+/**
+ * @brief Priorities of queued transactions, lower values go first
+ *
+ * The priorities only order the queue. The playback of the firmware reads
+ * with at25df641_stream_read_async() outside of the queue.
+ */
+typedef enum {
+    PRIO_PLAYBACK   = 0,    /**< read the audio output waits for, one at a time */
+    PRIO_NORMAL     = 1,    /**< commands of the user */
+    PRIO_BACKGROUND = 2     /**< caches and copies */
+} at25df641_prio_t;
+
+/**
+ * @brief Types of queued transactions
+ */
+typedef enum {
+    TRANS_READ  = 0,        /**< read via DMA */
+    TRANS_WRITE = 1,        /**< program in the background */
+    TRANS_ERASE = 2         /**< erase in the background */
+} at25df641_trans_type_t;
+
+/**
+ * @brief Queued transaction, owned by the driver til its callback
+ */
+typedef struct at25df641_trans {
+    struct at25df641_trans *next;   /**< next transaction of the queue */
+    at25df641_trans_type_t type;    /**< kind of the transaction */
+    at25df641_prio_t prio;          /**< priority */
+    at25df641_dev_t dev;            /**< device descriptor */
+    at25df641_erase_t erase_cmd;    /**< erase command of TRANS_ERASE */
+    unsigned char *data;            /**< read buffer or bytes to program */
+    uint32_t addr;                  /**< address */
+    uint32_t size;                  /**< number of bytes, 0 for TRANS_ERASE */
+    at25df641_cb_t cb;              /**< callback for the finished transaction, may be NULL */
+    void *arg;                      /**< argument passed to the callback */
+} at25df641_trans_t;
+
+/**
+ * @brief Chip protect default type defintion
+ */
+typedef enum {
+    UNPROTECT = 0,
+    PROTECT   = 1,
+} at25df641_prot_t;
+
+/**
+ * @brief Initialize an AT25DF641 module
+ *
+ * @param[in] dev       device descriptor
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_init(at25df641_dev_t dev);
+
+/**
+ * @brief Sends a command via SPI
+ *
+ * @param[in] dev       device descriptor
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_command_handler(at25df641_dev_t dev);
+
+/**
+ * @brief Write data with given length to the spi bus
+ */
+void write_spi(int length, unsigned char *data);
+
+/**
+ * @brief Read data with given length from the spi bus
+ */
+void read_spi(int length, unsigned char *data);
+
+/**
+ * @brief Write one block with 256 byte into the flash
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] *data     data buffer
+ * @param[in] size      number of bytes in buffer
+ * @param[in] addr      write address
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_write(at25df641_dev_t dev, unsigned char *data, uint16_t size,
+	                  uint32_t addr);
+
+/**
+ * @brief Gives write permissions
+ *
+ * @param[in] dev       device descriptor
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_enable_write(at25df641_dev_t dev);
+
+/**
+ * @brief Read one block with multiple Bytes from flash
+ *
+ * @param[in] dev       device descriptor
+ * @param[out] *data    readed data from memory
+ * @param[in] size      number of bytes needed to read from memory
+ * @param[in] address   address from where to read
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_read(at25df641_dev_t dev, unsigned char *data, uint32_t size,
+	                 uint32_t addr);
+
+/**
+ * @brief Returns the counters of the read cache
+ *
+ * Reads of up to one page by at25df641_read() go through a cache of
+ * AT25DF641_CACHE_PAGES pages with LRU replacement. Programmed and erased
+ * pages are dropped, larger reads and streams bypass the cache.
+ *
+ * @param[out] *stats   counters since the start
+ */
+void at25df641_cache_stats(at25df641_cache_stats_t *stats);
+
+/**
+ * @brief Drops all pages of the read cache
+ */
+void at25df641_cache_flush(void);
+
+/**
+ * @brief Writes through the write-combining buffer
+ *
+ * Small writes are gathered in AT25DF641_WCB_PAGES page buffers, so every
+ * page is programmed with one command. Like on the chip, bytes which are
+ * written twice keep the AND of both values. The buffer is flushed when
+ * AT25DF641_WCB_THRESHOLD pages are completely written or a page is needed
+ * and all buffers are in use, at25df641_wcb_poll() flushes after
+ * AT25DF641_WCB_TIMEOUT. at25df641_read() flushes the pages it reads, the
+ * other functions do not look into the buffer.
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] *data     data buffer
+ * @param[in] size      number of bytes in buffer
+ * @param[in] addr      write address
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error of a flush (see defines)
+ */
+int at25df641_wcb_write(at25df641_dev_t dev, const unsigned char *data, uint32_t size,
+                        uint32_t addr);
+
+/**
+ * @brief Programs all buffered pages and empties the buffer
+ *
+ * Blocks like at25df641_write(), but unprotects and protects every chip
+ * only once for all of its pages.
+ *
+ * @return               0 on success
+ * @return              ERROR_BUSY if a queued operation runs, the pages are kept
+ * @return              ERROR_x on other errors (see defines)
+ */
+int at25df641_wcb_flush(void);
+
+/**
+ * @brief Flushes the buffer, if a page waits longer than AT25DF641_WCB_TIMEOUT
+ *
+ * The time is counted by at25df641_tick().
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error of the flush (see defines)
+ */
+int at25df641_wcb_poll(void);
+
+/**
+ * @brief Returns the counters of the write-combining buffer
+ *
+ * @param[out] *stats   counters since the start
+ */
+void at25df641_wcb_stats(at25df641_wcb_stats_t *stats);
+
+/**
+ * @brief Starts reading a block from flash in the background via DMA
+ *
+ * The chip stays selected until all bytes are received, then the callback
+ * is called from interrupt context. Synchronous commands wait for a running
+ * transfer to be finished.
+ *
+ * @param[in] dev       device descriptor
+ * @param[out] *data    buffer for the data, valid when the callback is called
+ * @param[in] size      number of bytes to read, not limited to 16 bit
+ * @param[in] addr      address from where to read
+ * @param[in] cb        callback for the finished transfer, may be NULL
+ * @param[in] *arg      argument passed to the callback
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_read_async(at25df641_dev_t dev, unsigned char *data,
+	                       uint32_t size, uint32_t addr, at25df641_cb_t cb,
+	                       void *arg);
+
+/**
+ * @brief Opens a sequential read stream at the given address
+ *
+ * The read command is sent with the first stream read. Afterwards the chip
+ * stays selected and every further read continues at the next address
+ * without a new command. Other commands on the bus interrupt the stream,
+ * it is then restarted at its current address by the next stream read.
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] addr      start address of the stream
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_stream_open(at25df641_dev_t dev, uint32_t addr);
+
+/**
+ * @brief Reads the next bytes of an opened stream
+ *
+ * @param[in] dev       device descriptor
+ * @param[out] *data    readed data from memory
+ * @param[in] size      number of bytes to read
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_stream_read(at25df641_dev_t dev, unsigned char *data,
+	                        uint32_t size);
+
+/**
+ * @brief Reads the next bytes of an opened stream in the background via DMA
+ *
+ * Does not go through at25df641_submit(). It never waits for the bus and
+ * returns ERROR_BUSY while another read, queued or not, holds it. It wins
+ * against program and erase operations, which are suspended for it, but
+ * not against a running queued read or a step which programs or erases
+ * the sector of the read, so the caller has to retry.
+ *
+ * @param[in] dev       device descriptor
+ * @param[out] *data    buffer for the data, valid when the callback is called
+ * @param[in] size      number of bytes to read
+ * @param[in] cb        callback for the finished transfer, may be NULL
+ * @param[in] *arg      argument passed to the callback
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_stream_read_async(at25df641_dev_t dev, unsigned char *data,
+	                              uint32_t size, at25df641_cb_t cb, void *arg);
+
+/**
+ * @brief Returns the address of the next byte of the stream
+ *
+ * @param[in] dev       device descriptor
+ */
+uint32_t at25df641_stream_tell(at25df641_dev_t dev);
+
+/**
+ * @brief Deselects the chip and closes the stream
+ *
+ * @param[in] dev       device descriptor
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_stream_close(at25df641_dev_t dev);
+
+/**
+ * @brief Selects the read command used for the data array
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] mode      read mode
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_set_read_mode(at25df641_dev_t dev, at25df641_read_t mode);
+
+/**
+ * @brief Checks if an asynchronous read is still running
+ *
+ * @return               1 if busy
+ * @return               0 if idle
+ */
+int at25df641_async_busy(void);
+
+/**
+ * @brief Reads the status register from flash and returns it
+ *
+ * @param[in] dev       device descriptor
+ * @param[out] *status  returns one byte from status register
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_read_status(at25df641_dev_t dev, unsigned char *status);
+
+/**
+ * @brief Checks the ID of the chip device
+ *
+ * @param[in] dev       device descriptor
+ * @param[out] *dev_id  returns the device ID
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_read_id(at25df641_dev_t dev_id, uint32_t *id_val);
+
+/**
+ * @brief Checks the ID of the chip device
+ *
+ * @param[in] dev       device descriptor
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_check_id(at25df641_dev_t dev);
+
+/**
+ * @brief Reads the status register til the RDY/BSY-Bit is cleared
+ *
+ * @param[in] dev       device descriptor
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_wait_rdy(at25df641_dev_t dev);
+
+/**
+ * @brief Clear memory protection flag
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] prot_type en-,disables chip-protection
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_chip_protect(at25df641_dev_t dev,  at25df641_prot_t prot_type);
+
+/**
+ * @brief Writes one byte into the status register
+ *
+ * @param[in] dev       device descriptor
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_write_status(at25df641_dev_t dev, unsigned char data);
+
+/**
+ * @brief Erase one block from flash.
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] addr      address of the block which should be erased
+ * @param[in] erase_cmd erase command with different size
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_erase_block(at25df641_dev_t dev, uint32_t addr,
+	                        at25df641_erase_t erase_cmd);
+
+/**
+ * @brief Programs data in the background
+ *
+ * The pages are programmed one after another by at25df641_tick(). Reads
+ * of the chip suspend the programming, the tick resumes it. The chip has
+ * no valid data in the 64KB sector of a suspended step, so a read of this
+ * sector waits for the end of the step instead, asynchronous reads return
+ * ERROR_BUSY. Every chip runs one operation, the chips work in parallel.
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] *data     data buffer, has to stay valid til the callback
+ * @param[in] size      number of bytes in buffer
+ * @param[in] addr      write address
+ * @param[in] cb        callback for the finished operation, may be NULL
+ * @param[in] *arg      argument passed to the callback
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_write_async(at25df641_dev_t dev, const unsigned char *data,
+                          uint32_t size, uint32_t addr, at25df641_cb_t cb,
+                          void *arg);
+
+/**
+ * @brief Erases a block in the background
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] addr      address of the block
+ * @param[in] erase_cmd erase command with different size
+ * @param[in] cb        callback for the finished operation, may be NULL
+ * @param[in] *arg      argument passed to the callback
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_erase_async(at25df641_dev_t dev, uint32_t addr,
+                          at25df641_erase_t erase_cmd, at25df641_cb_t cb,
+                          void *arg);
+
+/**
+ * @brief Advances the background program/erase operations
+ *
+ * Has to be called periodically from a timer interrupt. Polls the status
+ * of every chip, starts the next page, resumes a suspended operation and
+ * calls the callback at the end. Then starts queued transactions. Skips if
+ * the bus is in use.
+ */
+void at25df641_tick(void);
+
+/**
+ * @brief Queues a transaction
+ *
+ * Queued transactions start in order of priority as soon as they can run:
+ * a read when the bus is free, a program or erase when its chip has no
+ * running operation. So an erase of one chip runs while the reads of the
+ * other one go on, a read of a busy chip suspends its operation. Started
+ * by the tick, the end of a queued read and by this function.
+ *
+ * A read with PRIO_PLAYBACK is not queued. It takes the single playback
+ * slot and starts at once if the bus is free, else at the end of the
+ * running read or the next tick, ahead of the whole queue. It never waits
+ * for the bus, so it may be submitted from interrupts.
+ *
+ * @param[in] *trans    transaction, has to stay valid til the callback
+ *
+ * @return               0 on success
+ * @return              ERROR_BUSY if the last playback read is not done
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_submit(at25df641_trans_t *trans);
+
+/**
+ * @brief Checks if a background program/erase operation is running on any chip
+ *
+ * @return              1 if running, 0 otherwise
+ */
+int at25df641_pe_busy(void);
+
+/**
+ * @brief Erases an address range with as few erase commands as possible
+ *
+ * Every 4KB sector of the range is blank checked first, blank sectors are
+ * skipped. The used sectors are covered with the mix of 4KB, 32KB and 64KB
+ * erases with the smallest typical erase time, never reaching outside of
+ * the range.
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] addr      start address, multiple of 4KB
+ * @param[in] len       number of bytes, multiple of 4KB, 0 erases nothing
+ *
+ * @return              number of erase commands
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_erase_range(at25df641_dev_t dev, uint32_t addr, uint32_t len);
+
+/**
+ * @brief Compares a specific address length, up to one page
+ *
+ * @return              number of different bytes
+ */
+int at25df641_compare(at25df641_dev_t fir, at25df641_dev_t sec,
+	                    uint16_t size, uint32_t address);
+
+/**
+ * @brief Compares an address range of two devices
+ *
+ * Both devices are read in blocks via DMA, the CRC unit checks each block
+ * and only blocks with different CRCs are compared byte by byte.
+ *
+ * @param[in] fir       first device descriptor
+ * @param[in] sec       second device descriptor
+ * @param[in] addr      start address
+ * @param[in] size      number of bytes
+ * @param[out] *ranges  ranges of different bytes, may be NULL
+ * @param[in] max       number of entries of ranges, further ranges are dropped
+ * @param[out] *count   number of stored ranges, may be NULL
+ *
+ * @return              number of different bytes
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_verify(at25df641_dev_t fir, at25df641_dev_t sec, uint32_t addr,
+                     uint32_t size, at25df641_range_t *ranges, int max,
+                     int *count);
+
+/**
+ * @brief Erase the whole chip
+ */
+int at25df641_chip_erase(at25df641_dev_t dev);
+
+/**
+ * @brief Compares both memory devices
+ *
+ * @return              number of different bytes
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_compare_all(void);
+
+/**
+ * @brief Makes the content of dst equal to src, changing as little as possible
+ *
+ * Compares the CRCs of the 4KB sectors of every 64KB block. Equal blocks
+ * are skipped. Sectors which only need bits cleared are programmed over,
+ * the others erased, a whole block with one command if all its sectors
+ * need it. Only pages which differ are programmed.
+ *
+ * @param[in] dst       device which is changed
+ * @param[in] src       device with the wanted content
+ * @param[out] *stats   statistics, may be NULL, is not cleared
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_sync(at25df641_dev_t dst, at25df641_dev_t src, at25df641_sync_t *stats);
+
+/**
+ * @brief Like at25df641_sync(), limited to the 64KB blocks of a range
+ *
+ * @param[in] dst       device which is changed
+ * @param[in] src       device with the wanted content
+ * @param[in] start     first address of the range
+ * @param[in] len       number of bytes of the range
+ * @param[out] *stats   statistics, may be NULL, is not cleared
+ *
+ * @return               0 on success
+ * @return              ERROR_x on error (see defines)
+ */
+int at25df641_sync_range(at25df641_dev_t dst, at25df641_dev_t src, uint32_t start,
+                         uint32_t len, at25df641_sync_t *stats);
+
+/**
+ * @brief Copies the whole content from one to another memory device
+ *
+ * Synchronises the work device (AT25DF641_0) with the original device
+ * (AT25DF641_1) by at25df641_sync().
+ */
+int at25df641_copy_all(void);
+
+#endif /* AT25DF641_H */
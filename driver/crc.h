@@ -0,0 +1,45 @@
+/**
+ * @{
+ *
+ * @brief     Low-level peripherial device driver interface for CRC.
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+
+#include "config/periph_conf.h"
+
+/**
+ * @brief   Enables the clock of the CRC unit
+ */
+void crc_init(void);
+
+/**
+ * @brief   Calculates the CRC-32 (poly 0x04C11DB7) of a buffer
+ *
+ * The unit takes 32 bit words, a tail of 1 - 3 bytes is padded with zeros.
+ *
+ * @param[in] *data   word aligned buffer
+ * @param[in] len     number of bytes
+ *
+ * @return            CRC of the buffer
+ */
+uint32_t crc_calc(const void *data, uint32_t len);
+
+/**
+ * @brief   Continues a CRC calculation started with crc_calc()
+ *
+ * @param[in] *data   word aligned buffer
+ * @param[in] len     number of bytes
+ *
+ * @return            CRC over all buffers since the last crc_calc()
+ */
+uint32_t crc_update(const void *data, uint32_t len);
+
+#endif /* CRC_H */
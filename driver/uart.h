@@ -0,0 +1,78 @@
+/**
+ * @{
+ *
+ * @brief     Low-level peripherial device driver interface for UART.
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef UART_H
+#define UART_H
+
+#include <stdint.h>
+#include "config/periph_conf.h"
+
+/**
+ * @brief Definition available UART devices
+ */
+typedef enum {
+#if UART_0_EN
+    UART_0 = 0,   /**< UART device 0 */
+#endif
+#if UART_1_EN
+    UART_1 = 1    /**< UART device 1 */
+#endif
+} uart_t;
+
+/**
+ * @brief Initialize the UART device with 8N1
+ *
+ * @param[in] dev    UART device descriptor
+ * @param[in] baud   baudrate in bit per second
+ *
+ * @return            0 on succes
+ * @return           -1 on error
+ */
+int uart_init(uart_t dev, uint32_t baud);
+
+/**
+ * @brief Sends bytes, waits til the last one is in the transmit register
+ *
+ * @param[in] dev    UART device descriptor
+ * @param[in] *data  bytes to send
+ * @param[in] len    number of bytes
+ */
+void uart_write(uart_t dev, const unsigned char *data, int len);
+
+/**
+ * @brief Starts receiving into a ring buffer via circular DMA
+ *
+ * The DMA starts at the begin of the buffer again after the last byte, so
+ * the reader has to keep up. A running reception is restarted.
+ *
+ * @param[in] dev    UART device descriptor
+ * @param[out] *buf  ring buffer
+ * @param[in] len    size of the ring, 1 to 65535
+ *
+ * @return            0 on succes
+ * @return           -1 on error
+ */
+int uart_rx_start(uart_t dev, unsigned char *buf, uint16_t len);
+
+/**
+ * @brief Returns the position of the next received byte in the ring
+ *
+ * @param[in] dev    UART device descriptor
+ */
+uint16_t uart_rx_pos(uart_t dev);
+
+/**
+ * @brief Stops the reception
+ *
+ * @param[in] dev    UART device descriptor
+ */
+void uart_rx_stop(uart_t dev);
+
+#endif /* UART_H */
@@ -0,0 +1,70 @@
+/**
+ * @{
+ *
+ * @brief     Circular input buffer of the mp3 decoder
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#include "include/inbuf.h"
+
+/** Maps a byte counter to a position in the ring */
+#define INDEX(x)        ((x) & (INBUF_SIZE - 1))
+
+void inbuf_reset(inbuf_t *buf)
+{
+    buf->rd = 0;
+    buf->wr = 0;
+}
+
+int inbuf_fill(inbuf_t *buf)
+{
+    return (int)(buf->wr - buf->rd);
+}
+
+unsigned char *inbuf_read_ptr(inbuf_t *buf, int *len)
+{
+    uint32_t pos = INDEX(buf->rd);
+    int fill = inbuf_fill(buf);
+    int contiguous = (INBUF_SIZE + INBUF_GUARD) - pos;
+
+    *len = (fill < contiguous) ? fill : contiguous;
+
+    return &buf->data[pos];
+}
+
+void inbuf_consume(inbuf_t *buf, int len)
+{
+    buf->rd += len;
+}
+
+unsigned char *inbuf_write_ptr(inbuf_t *buf, int *len)
+{
+    uint32_t pos = INDEX(buf->wr);
+    int space = INBUF_SIZE - inbuf_fill(buf);
+    int contiguous = INBUF_SIZE - pos;
+
+    *len = (space < contiguous) ? space : contiguous;
+
+    return &buf->data[pos];
+}
+
+void inbuf_commit(inbuf_t *buf, int len)
+{
+    uint32_t pos = INDEX(buf->wr);
+    uint32_t n = (uint32_t)len;
+
+    /* mirror the bytes written to the start of the ring into the guard */
+    if (pos < INBUF_GUARD)
+    {
+        memcpy(&buf->data[INBUF_SIZE + pos], &buf->data[pos],
+               ((pos + n) < INBUF_GUARD) ? n : (INBUF_GUARD - pos));
+    }
+
+    buf->wr += n;
+}
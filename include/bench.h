@@ -0,0 +1,110 @@
+/**
+ * @{
+ *
+ * @brief     Throughput measurements of the application components
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#include "driver/at25df641.h"
+
+/**
+ * @brief Enables the DWT cycle counter
+ */
+void bench_init(void);
+
+/**
+ * @brief Returns the current value of the cycle counter
+ */
+uint32_t bench_cycles(void);
+
+/**
+ * @brief Prints a throughput in bytes per second next to the wire speed
+ *
+ * @param[in] *name     name of the measurement
+ * @param[in] bytes     number of transferred bytes
+ * @param[in] cycles    cpu cycles needed for the transfer
+ * @param[in] wire_hz   clock of the bus, 0 if not applicable
+ */
+void bench_report(const char *name, uint32_t bytes, uint32_t cycles,
+                  uint32_t wire_hz);
+
+/**
+ * @brief Returns the cpu load of a decoder
+ *
+ * @param[in] cycles    cpu cycles needed for decoding
+ * @param[in] samples   number of decoded samples per channel
+ * @param[in] rate      sample rate of the output in Hz
+ *
+ * @return              load in 1/1000 of the cpu, 0 without samples
+ */
+uint32_t bench_load(uint64_t cycles, uint32_t samples, uint32_t rate);
+
+/**
+ * @brief Prints the cycles a decoder needs per second of audio
+ *
+ * @param[in] *name     name of the decoder
+ * @param[in] cycles    cpu cycles needed for decoding
+ * @param[in] samples   number of decoded samples per channel
+ * @param[in] rate      sample rate of the output in Hz
+ */
+void bench_report_load(const char *name, uint64_t cycles, uint32_t samples,
+                       uint32_t rate);
+
+/**
+ * @brief Measures the sustained read throughput of a flash device
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] wire_hz   SPI clock of the device
+ */
+void bench_flash_read(at25df641_dev_t dev, uint32_t wire_hz);
+
+/**
+ * @brief Measures the page compare against the CRC verification of both chips
+ *
+ * @param[in] wire_hz   SPI clock of the devices
+ */
+void bench_flash_verify(uint32_t wire_hz);
+
+/**
+ * @brief Measures small appends with at25df641_write and the write-combining buffer
+ *
+ * Erases the 64KB block at addr twice, its content is lost.
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] addr      address of the block
+ */
+void bench_flash_append(at25df641_dev_t dev, uint32_t addr);
+
+/**
+ * @brief Measures the sample throughput of fsmc_transfer_block
+ *
+ * Sends a block of FIFO words through the filter of the FPGA again and
+ * again, each word is written and read back.
+ *
+ * @param[in] clk_hz    FSMC_CLK, 0 in asynchronous mode
+ */
+void bench_fsmc(uint32_t clk_hz);
+
+/**
+ * @brief Measures the frames per second of the MP3 decoder
+ *
+ * Reads up to 16KB of a track into memory and decodes it without output,
+ * so the result does not depend on the flash. Only fully decoded frames
+ * and their cycles count, frames which miss their bit reservoir at the
+ * start are left out.
+ *
+ * @param[in] dev       device descriptor
+ * @param[in] addr      address of the first frame
+ * @param[in] len       number of bytes of the track behind addr
+ */
+void bench_mp3_decode(at25df641_dev_t dev, uint32_t addr, uint32_t len);
+
+#endif /* BENCH_H */
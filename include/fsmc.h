@@ -1,24 +1,41 @@
-/**
- * @{
- *
- * @brief     Interface of the fsmc module.
- * @author    Copyright (C) Ren Herthel <rene-herthel@outlook.de>
- * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
- *
- * @}
- */
-
-#ifndef FSMC_H
-#define FSMC_H
-
-/**
- * @brief Initialize the fsmc pin interface
- */
-int fsmc_init(void);
-
-/**
- * @brief Transfers data through the fsmc
- */
-void fsmc_transfer(int16_t wr_val, int16_t *rd_val);
-
-#endif /* FMSC_H */
+/**
+ * @{
+ *
+ * @brief     Interface of the fsmc module.
+ * @author    Copyright (C) Ren Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef FSMC_H
+#define FSMC_H
+
+/**
+ * @brief Initialize the fsmc pin interface
+ */
+int fsmc_init(void);
+
+/**
+ * @brief Transfers data through the fsmc
+ */
+void fsmc_transfer(int16_t wr_val, int16_t *rd_val);
+
+/**
+ * @brief Returns the FSMC_CLK in Hz, 0 in asynchronous mode
+ */
+uint32_t fsmc_clock(void);
+
+/**
+ * @brief Sends a block of words to the FPGA and overwrites it with the
+ *        processed words. Uses bursts when the synchronous mode is enabled.
+ *
+ * Unlike fsmc_transfer(), which skips a write of 0, every word is written,
+ * so zero samples go through the filter as well. In synchronous mode DMA2
+ * stream 0 moves the words in bursts of 8 with 16 bit accesses, so data
+ * has to lie in DMA reachable SRAM (not the CCM). A rest of less than 8
+ * words goes with single accesses.
+ */
+void fsmc_transfer_block(int16_t *data, int len);
+
+#endif /* FMSC_H */
@@ -0,0 +1,69 @@
+/**
+ * @{
+ *
+ * @brief     Circular input buffer of the mp3 decoder
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef INBUF_H
+#define INBUF_H
+
+#include <stdint.h>
+
+/** Size of the ring, has to be a power of two */
+#define INBUF_SIZE      (16384)
+/** Size of the guard behind the ring, largest block read at once (MAINBUF_SIZE) */
+#define INBUF_GUARD     (1940)
+
+/**
+ * @brief Circular buffer with a mirrored guard region
+ *
+ * The first INBUF_GUARD bytes of the ring are mirrored behind its end, so
+ * at least INBUF_GUARD (or all available) bytes can be read contiguously
+ * from any position. Only the writer moves the write counter and only the
+ * reader moves the read counter, so one of them may run in an interrupt.
+ */
+typedef struct {
+    unsigned char data[INBUF_SIZE + INBUF_GUARD]; /**< ring and guard */
+    volatile uint32_t rd;   /**< total number of consumed bytes */
+    volatile uint32_t wr;   /**< total number of written bytes */
+} inbuf_t;
+
+/**
+ * @brief Empties the buffer
+ */
+void inbuf_reset(inbuf_t *buf);
+
+/**
+ * @brief Returns the number of readable bytes
+ */
+int inbuf_fill(inbuf_t *buf);
+
+/**
+ * @brief Returns the next readable byte
+ *
+ * @param[out] *len     number of contiguous readable bytes
+ */
+unsigned char *inbuf_read_ptr(inbuf_t *buf, int *len);
+
+/**
+ * @brief Marks bytes as read
+ */
+void inbuf_consume(inbuf_t *buf, int len);
+
+/**
+ * @brief Returns the free space at the write position
+ *
+ * @param[out] *len     number of contiguous free bytes
+ */
+unsigned char *inbuf_write_ptr(inbuf_t *buf, int *len);
+
+/**
+ * @brief Marks bytes at the write position as written
+ */
+void inbuf_commit(inbuf_t *buf, int len);
+
+#endif /* INBUF_H */
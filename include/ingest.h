@@ -0,0 +1,91 @@
+/**
+ * @{
+ *
+ * @brief     Upload of new flash content over the UART during playback
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <stdint.h>
+
+/**
+ * The protocol is shared with the host tool tools/upload, so this part only
+ * depends on stdint.h. All values are little endian.
+ *
+ * WRITE: the host sends INGEST_CMD_WRITE, the address and the length as
+ * 32 bit values. The board answers with INGEST_REPLY_CREDIT for every
+ * INGEST_CHUNK bytes the host may send. It grants one more credit for
+ * every chunk which is programmed. At the end it answers INGEST_REPLY_OK
+ * and the CRC-32 of the data (STM32 CRC unit, the tail padded with zeros),
+ * or INGEST_REPLY_ERROR and the status. The rest of the last 64KB block
+ * is erased.
+ *
+ * COMMIT: the host sends INGEST_CMD_COMMIT, the board stops the playback,
+ * makes the blocks of all WRITEs since the last commit on the orig chip
+ * equal to the work chip and reloads the directory. It answers
+ * INGEST_REPLY_OK and 0, or INGEST_REPLY_ERROR and the status.
+ */
+
+/** Baudrate of the upload */
+#define INGEST_BAUD         (921600)
+/** Bytes per credit, written to the flash at once */
+#define INGEST_CHUNK        (4096)
+/** Chunks of the receive ring */
+#define INGEST_CHUNKS       (8)
+/** Erase unit, WRITE addresses have to be aligned to it */
+#define INGEST_BLOCK        (64 * 1024)
+
+/** Commands of the host */
+#define INGEST_CMD_WRITE    ('W')   /**< followed by address and length */
+#define INGEST_CMD_COMMIT   ('C')   /**< no arguments */
+
+/** Replies of the board */
+#define INGEST_REPLY_CREDIT ('+')   /**< room for INGEST_CHUNK bytes */
+#define INGEST_REPLY_OK     ('K')   /**< WRITE: followed by the CRC */
+#define INGEST_REPLY_ERROR  ('!')   /**< followed by the status as int8_t */
+
+/** Results of ingest_poll() */
+#define INGEST_EV_NONE      (0)     /**< nothing to do for the application */
+#define INGEST_EV_WRITE     (1)     /**< a WRITE starts to change the work chip */
+#define INGEST_EV_COMMIT    (2)     /**< the host waits for ingest_commit() */
+
+/**
+ * @brief Starts listening on the UART
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int ingest_init(void);
+
+/**
+ * @brief Moves received data to the flash and answers the host
+ *
+ * Never waits, has to be called at least once per output buffer. The
+ * chunks are programmed into the work chip with background priority,
+ * the erases are queued one block ahead of the write position.
+ *
+ * @return              INGEST_EV_x
+ */
+int ingest_poll(void);
+
+/**
+ * @brief Checks if a WRITE is running
+ *
+ * @return              1 if running, 0 otherwise
+ */
+int ingest_busy(void);
+
+/**
+ * @brief Copies the work chip to the orig chip and answers the host
+ *
+ * Blocks til the copy is done, the playback has to be stopped before.
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int ingest_commit(void);
+
+#endif /* INGEST_H */
@@ -0,0 +1,93 @@
+/**
+ * @{
+ *
+ * @brief     Cache of the decoded track starts on the work chip
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Every track of the directory has a slot of PCMCACHE_SLOT bytes on the
+ * work chip (AT25DF641_0). It holds the output frames of the start of the
+ * track as they leave the FPGA, ready for the DAC and PWM. A cached start
+ * is replayed without decoding while the decoder seeks behind it.
+ *
+ * The slots are filled in the background during normal playback. Every
+ * frame is programmed with its flag behind it, a slot may be filled over
+ * several plays. The cached output depends on the settings of the FPGA.
+ *
+ * @}
+ */
+
+#ifndef PCMCACHE_H
+#define PCMCACHE_H
+
+#include <stdint.h>
+
+#include "include/trackdir.h"
+
+/** Modes of the cache */
+#define PCMCACHE_OFF        (0) /**< no caching */
+#define PCMCACHE_ALL        (1) /**< the start of every track */
+#define PCMCACHE_SELECTED   (2) /**< tracks with TRACKDIR_FLAG_PCMCACHE */
+
+/** Bytes of the slot of a track, a multiple of 64KB */
+#define PCMCACHE_SLOT       (256 * 1024)
+/** Maximum number of frames of a slot */
+#define PCMCACHE_MAX_FRAMES (64)
+/** Identifies a slot header */
+#define PCMCACHE_MAGIC      (0x4D435043)
+
+/**
+ * @brief Header in the first page of a slot
+ */
+typedef struct {
+    uint32_t magic;         /**< PCMCACHE_MAGIC */
+    uint32_t offset;        /**< offset of the track, detects a new image */
+    uint32_t length;        /**< length of the track */
+    uint16_t frame_bytes;   /**< bytes of one output frame */
+    uint16_t frames;        /**< frames of the slot */
+    uint8_t filled[PCMCACHE_MAX_FRAMES]; /**< 0x00 if the frame is stored */
+} pcmcache_hdr_t;
+
+/**
+ * @brief Sets the mode and the size of the output frames
+ *
+ * @param[in] mode          PCMCACHE_x
+ * @param[in] frame_bytes   bytes of one output frame
+ */
+void pcmcache_init(int mode, uint32_t frame_bytes);
+
+/**
+ * @brief Opens the slot of a track which is started
+ *
+ * A slot of another track or image is erased in the background.
+ *
+ * @param[in] n         number of the track
+ * @param[in] *track    directory entry of the track
+ *
+ * @return              number of cached frames from the start of the track
+ */
+int pcmcache_open(int n, const trackdir_entry_t *track);
+
+/**
+ * @brief Reads a cached frame of the opened track
+ *
+ * @param[in] frame     number of the frame
+ * @param[out] *pcm     buffer of frame_bytes
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int pcmcache_read(uint32_t frame, int16_t *pcm);
+
+/**
+ * @brief Offers a finished output frame of the opened track
+ *
+ * The frame is copied and programmed in the background if it is missing
+ * and the last one is done. Called once per full output frame, replay
+ * stops at the first frame which was not offered.
+ *
+ * @param[in] frame     number of the frame
+ * @param[in] *pcm      output frame of frame_bytes
+ */
+void pcmcache_offer(uint32_t frame, const int16_t *pcm);
+
+#endif /* PCMCACHE_H */
@@ -0,0 +1,66 @@
+/**
+ * @{
+ *
+ * @brief     Decoder of the PCM and IMA-ADPCM tracks
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef PCMDEC_H
+#define PCMDEC_H
+
+#include <stdint.h>
+
+#include "include/inbuf.h"
+#include "include/trackdir.h"
+#include "driver/at25df641.h"
+
+/** Samples per channel of the largest ADPCM block, the header holds one */
+#define PCMDEC_BLOCK_SAMPLES    ((TRACKDIR_ADPCM_BLOCK_MAX - 4) * 2 + 1)
+
+/**
+ * @brief Opened PCM or ADPCM track
+ *
+ * An ADPCM block does not fit the output frames, so it is decoded into the
+ * stage and handed out from there.
+ */
+typedef struct {
+    uint8_t format;             /**< TRACKDIR_FMT_PCM16 or TRACKDIR_FMT_ADPCM */
+    uint8_t channels;           /**< number of channels, 1 or 2 */
+    uint16_t block_align;       /**< bytes of an ADPCM block */
+    int bitrate;                /**< bits per second, from the WAV header */
+    int16_t stage[PCMDEC_BLOCK_SAMPLES];            /**< decoded block, interleaved */
+    int stage_len;              /**< number of samples in the stage */
+    int stage_pos;              /**< next sample of the stage */
+    unsigned char block[TRACKDIR_ADPCM_BLOCK_MAX];  /**< block across the ring end */
+} pcmdec_t;
+
+/**
+ * @brief Reads and checks the WAV header of a track
+ *
+ * @param[in] *dec      decoder to open
+ * @param[in] dev       device descriptor
+ * @param[in] *track    directory entry of the track
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int pcmdec_open(pcmdec_t *dec, at25df641_dev_t dev, const trackdir_entry_t *track);
+
+/**
+ * @brief Decodes interleaved stereo samples from the input buffer
+ *
+ * Mono tracks are output on both channels. Waits for the read-ahead.
+ *
+ * @param[in] *dec      opened decoder
+ * @param[in] *in       input buffer, filled from the first sample on
+ * @param[out] *out     output samples
+ * @param[in] len       number of wanted samples, a multiple of two
+ *
+ * @return              number of output samples, less than len only at
+ *                      the end of the track
+ */
+int pcmdec_decode(pcmdec_t *dec, inbuf_t *in, int16_t *out, int len);
+
+#endif /* PCMDEC_H */
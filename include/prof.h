@@ -0,0 +1,78 @@
+/**
+ * @{
+ *
+ * @brief     Cycles of the play loop stages per frame
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * The caller measures the stages with its own clock, the DWT cycle counter
+ * on the board (bench_cycles()) or the clock of the host, and hands the
+ * differences to prof_add(). prof_frame() closes a frame, the sum of each
+ * stage in the frame goes into its minimum, average and maximum.
+ *
+ * The decoder is a single stage. The MP3 library is linked as a binary,
+ * so its Huffman decoding, dequantization, IMDCT and synthesis can not be
+ * timed apart.
+ *
+ * @}
+ */
+
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+
+/** Stages of the play loop */
+#define PROF_INPUT      (0)     /**< read-ahead or stream wait and sync search */
+#define PROF_WAIT       (1)     /**< wait for free output slots */
+#define PROF_DECODE     (2)     /**< MP3Decode, pcmdec_decode or the cache read */
+#define PROF_OUTPUT     (3)     /**< FSMC transfer, amplification and hand over */
+#define PROF_FLASH      (4)     /**< read-ahead poll and the PCM cache */
+#define PROF_STAGES     (5)     /**< number of stages */
+
+/**
+ * @brief Per frame statistics of a stage
+ */
+typedef struct {
+    uint32_t frames;        /**< number of closed frames */
+    uint32_t min;           /**< least time of the stage in a frame */
+    uint32_t avg;           /**< average time of the stage per frame */
+    uint32_t max;           /**< largest time of the stage in a frame */
+} prof_stats_t;
+
+/**
+ * @brief Drops all measurements
+ */
+void prof_reset(void);
+
+/**
+ * @brief Adds the time of a stage to the current frame
+ *
+ * @param[in] stage     PROF_x
+ * @param[in] time      time of the stage in units of the caller's clock
+ */
+void prof_add(int stage, uint32_t time);
+
+/**
+ * @brief Closes the current frame
+ *
+ * Stages which did not run in the frame count with 0.
+ */
+void prof_frame(void);
+
+/**
+ * @brief Returns the statistics of a stage
+ *
+ * @param[in] stage     PROF_x
+ * @param[out] *stats   statistics, all 0 without a closed frame
+ */
+void prof_get(int stage, prof_stats_t *stats);
+
+/**
+ * @brief Prints the statistics of all stages in microseconds
+ *
+ * @param[in] freq      ticks per second of the caller's clock
+ */
+void prof_report(uint32_t freq);
+
+#endif /* PROF_H */
@@ -0,0 +1,74 @@
+/**
+ * @{
+ *
+ * @brief     Background read-ahead of compressed data into the input buffer
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef READAHEAD_H
+#define READAHEAD_H
+
+#include <stdint.h>
+
+#include "include/inbuf.h"
+#include "driver/at25df641.h"
+
+/** Playback time which is kept prefetched */
+#define READAHEAD_MS        (250)
+/** Largest block read with one DMA transfer */
+#define READAHEAD_CHUNK     (1024)
+/** Lower bound of the prefetch depth, one decoder block plus a frame */
+#define READAHEAD_MIN       (2 * INBUF_GUARD)
+
+/**
+ * @brief Starts prefetching a stream into the input buffer
+ *
+ * Reads with PRIO_PLAYBACK, they take the bus ahead of every queued
+ * transaction. Every finished transfer starts the next one from the DMA
+ * interrupt, til the prefetch depth is reached or the end of the stream.
+ *
+ * @param[in] *buf      input buffer, is emptied
+ * @param[in] dev       device descriptor
+ * @param[in] addr      start address of the stream
+ * @param[in] len       length of the stream in bytes
+ */
+void readahead_start(inbuf_t *buf, at25df641_dev_t dev, uint32_t addr, uint32_t len);
+
+/**
+ * @brief Stops prefetching and waits for the running transfer
+ */
+void readahead_stop(void);
+
+/**
+ * @brief Restarts prefetching if it stopped at the prefetch depth
+ */
+void readahead_poll(void);
+
+/**
+ * @brief Adapts the prefetch depth to the bitrate of the stream
+ *
+ * @param[in] bitrate   bitrate in bits per second, from MP3FrameInfo
+ */
+void readahead_set_bitrate(int bitrate);
+
+/**
+ * @brief Waits til the given number of bytes is prefetched
+ *
+ * Returns early at the end of the stream. Every wait counts as underrun,
+ * except the first one after readahead_start().
+ *
+ * @param[in] bytes     needed number of bytes
+ *
+ * @return              number of available bytes
+ */
+int readahead_wait(int bytes);
+
+/**
+ * @brief Returns the number of times the decoder had to wait for data
+ */
+uint32_t readahead_underruns(void);
+
+#endif /* READAHEAD_H */
@@ -0,0 +1,71 @@
+/**
+ * @{
+ *
+ * @brief     Frame seek index of a track
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef SEEKIDX_H
+#define SEEKIDX_H
+
+#include <stdint.h>
+
+#include "include/trackdir.h"
+#include "driver/at25df641.h"
+
+/** Largest bit reservoir of a layer 3 frame (main_data_begin) */
+#define SEEKIDX_RESERVOIR   (511)
+
+/**
+ * @brief Opened seek index of a track
+ */
+typedef struct {
+    at25df641_dev_t dev;    /**< device of the track */
+    uint32_t addr;          /**< flash address of the first group */
+    seekidx_hdr_t hdr;      /**< header of the index */
+} seekidx_t;
+
+/**
+ * @brief Reads and checks the header of the seek index of a track
+ *
+ * @param[in] *idx      index to open
+ * @param[in] dev       device descriptor
+ * @param[in] *track    directory entry of the track
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int seekidx_open(seekidx_t *idx, at25df641_dev_t dev, const trackdir_entry_t *track);
+
+/**
+ * @brief Converts a time position into a frame number
+ *
+ * @param[in] *idx      opened index
+ * @param[in] msec      position in milliseconds
+ *
+ * @return              number of the frame, limited to the last frame
+ */
+uint32_t seekidx_frame_at(const seekidx_t *idx, uint32_t msec);
+
+/**
+ * @brief Looks up the start of a frame and the frames to decode before it
+ *
+ * The bit reservoir of a frame may reach back into the frames before. To
+ * decode the wanted frame correctly the decoder is fed from the returned
+ * offset and drops the output of the first preroll frames. The preroll
+ * covers SEEKIDX_RESERVOIR bytes of main data, headers and side info of
+ * the frames are not counted. Needs one read, more if the preroll reaches
+ * into the groups before.
+ *
+ * @param[in] *idx      opened index
+ * @param[in] frame     wanted frame
+ * @param[in] *offset   offset of the first frame to decode, from track start
+ * @param[in] *preroll  number of frames to decode before the wanted frame
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int seekidx_seek(const seekidx_t *idx, uint32_t frame, uint32_t *offset, int *preroll);
+
+#endif /* SEEKIDX_H */
@@ -0,0 +1,132 @@
+/**
+ * @{
+ *
+ * @brief     Live MP3 stream over the UART with an adaptive jitter buffer
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdint.h>
+
+#include "include/inbuf.h"
+
+/** Baudrate of the stream */
+#define STREAM_BAUD         (921600)
+/** Size of the DMA receive ring, stream_poll() has to empty it in time */
+#define STREAM_RX_SIZE      (8192)
+/** Start value of the jitter buffer target in playback time */
+#define STREAM_TARGET_MS    (200)
+/** Lower bound of the target */
+#define STREAM_TARGET_MIN   (50)
+/** Change of the target per underrun or per window without need */
+#define STREAM_STEP_MS      (50)
+/** Time over which the lowest fill level is tracked */
+#define STREAM_WINDOW_MS    (5000)
+/** Time without data which ends a stream */
+#define STREAM_TIMEOUT_MS   (500)
+/** Assumed bitrate til the first frame is decoded */
+#define STREAM_BITRATE      (128000)
+
+/** Results of stream_poll() */
+#define STREAM_EV_NONE      (0)     /**< nothing to do for the application */
+#define STREAM_EV_START     (1)     /**< data of a new stream, call stream_start() */
+#define STREAM_EV_END       (2)     /**< the stream is played to its end */
+
+/** States of the stream */
+#define STREAM_IDLE         (0)     /**< waiting for data */
+#define STREAM_BUFFERING    (1)     /**< filling up to the target */
+#define STREAM_PLAYING      (2)     /**< the decoder takes data */
+#define STREAM_FLUSH        (3)     /**< drops a stopped stream til the line is quiet */
+
+/**
+ * @brief Fill level and counters of the current stream
+ */
+typedef struct {
+    int state;              /**< STREAM_x */
+    uint32_t fill_ms;       /**< buffered playback time */
+    uint32_t target_ms;     /**< fill level which is buffered before playing */
+    uint32_t received;      /**< received bytes */
+    uint32_t underruns;     /**< times the decoder found the buffer empty */
+    uint32_t overruns;      /**< times received data was dropped as the buffer was full */
+    uint32_t dropped;       /**< frames dropped to lower the latency */
+} stream_stats_t;
+
+/**
+ * @brief Starts listening on the UART
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int stream_init(void);
+
+/**
+ * @brief Time base of the timeout and the window, has to be called every 1ms
+ */
+void stream_tick(void);
+
+/**
+ * @brief Moves received data into the input buffer and adapts the target
+ *
+ * Never waits, has to be called at least every STREAM_RX_SIZE bytes of the
+ * line (89ms at STREAM_BAUD).
+ *
+ * @return              STREAM_EV_x
+ */
+int stream_poll(void);
+
+/**
+ * @brief Starts buffering a new stream into the input buffer
+ *
+ * @param[in] *buf      input buffer of the decoder, is emptied
+ */
+void stream_start(inbuf_t *buf);
+
+/**
+ * @brief Stops the stream, the rest of it is dropped
+ */
+void stream_stop(void);
+
+/**
+ * @brief Checks if the decoder may take the given number of bytes
+ *
+ * Never waits. A buffer which runs empty while playing is filled up to the
+ * target again. If the stream goes on, it counts as underrun and raises the
+ * target by STREAM_STEP_MS. At the end of the stream the rest is handed
+ * out, even if it is shorter.
+ *
+ * @param[in] bytes     needed number of bytes
+ *
+ * @return              1 if the decoder may run, 0 otherwise
+ */
+int stream_ready(int bytes);
+
+/**
+ * @brief Checks if the output of the decoded frame has to be dropped
+ *
+ * If the fill level stayed above the target for a whole window, because
+ * the target was lowered or the sender is faster than the output, frames
+ * are dropped til the fill level is down at the target.
+ *
+ * @return              1 to drop the output, 0 to play it
+ */
+int stream_skip(void);
+
+/**
+ * @brief Converts between bytes and playback time with the bitrate of the stream
+ *
+ * @param[in] bitrate   bitrate in bits per second, from MP3FrameInfo
+ */
+void stream_set_bitrate(int bitrate);
+
+/**
+ * @brief Returns the fill level and the counters of the current stream
+ *
+ * @param[out] *stats   fill level and counters
+ */
+void stream_stats(stream_stats_t *stats);
+
+#endif /* STREAM_H */
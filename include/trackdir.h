@@ -0,0 +1,149 @@
+/**
+ * @{
+ *
+ * @brief     Track directory stored on the serial flash
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef TRACKDIR_H
+#define TRACKDIR_H
+
+#include <stdint.h>
+
+/**
+ * The layout is shared with the host tools which build the flash image, so
+ * this header only depends on stdint.h. All fields are little endian.
+ */
+
+/** Flash address of the directory, the last 64KB block of the chip */
+#define TRACKDIR_ADDR       (0x7F0000)
+/** Identification of a valid directory ("TDIR") */
+#define TRACKDIR_MAGIC      (0x52494454)
+/** Version of the layout */
+#define TRACKDIR_VERSION    (1)
+/** Maximum number of tracks */
+#define TRACKDIR_MAX        (32)
+
+/** Encodings of a track */
+#define TRACKDIR_FMT_MP3    (0)
+#define TRACKDIR_FMT_PCM16  (1) /**< WAV, 16 bit signed samples */
+#define TRACKDIR_FMT_ADPCM  (2) /**< WAV, 4 bit IMA-ADPCM blocks */
+
+/** Largest block of an IMA-ADPCM track */
+#define TRACKDIR_ADPCM_BLOCK_MAX    (2048)
+
+/** Flags of a track */
+#define TRACKDIR_FLAG_PCMCACHE  (1 << 0) /**< keep the decoded start on the work chip */
+
+/**
+ * @brief One entry of the directory
+ */
+typedef struct {
+    uint32_t offset;        /**< flash address of the track */
+    uint32_t length;        /**< number of bytes of the track */
+    uint32_t first_frame;   /**< offset of the first frame (WAV: samples) from offset */
+    uint32_t samplerate;    /**< sample rate in Hz */
+    uint8_t channels;       /**< number of channels */
+    uint8_t format;         /**< encoding, TRACKDIR_FMT_x */
+    uint16_t flags;         /**< TRACKDIR_FLAG_x */
+    uint32_t index;         /**< flash address of the seek index, 0 if none */
+} trackdir_entry_t;
+
+/**
+ * @brief Directory header followed by the entries
+ */
+typedef struct {
+    uint32_t magic;         /**< TRACKDIR_MAGIC */
+    uint16_t version;       /**< TRACKDIR_VERSION */
+    uint16_t count;         /**< number of used entries */
+    uint32_t checksum;      /**< trackdir_checksum() of the entries */
+    uint32_t reserved;      /**< reserved, 0 */
+    trackdir_entry_t entry[TRACKDIR_MAX]; /**< tracks */
+} trackdir_t;
+
+/** Identification of a seek index ("SIDX") */
+#define SEEKIDX_MAGIC       (0x58444953)
+/** Number of frames of one index group */
+#define SEEKIDX_GROUP       (16)
+
+/**
+ * @brief Header of a seek index, stored at trackdir_entry_t.index
+ *
+ * The header is followed by (frames + SEEKIDX_GROUP - 1) / SEEKIDX_GROUP
+ * groups, so the group of any frame is found with one read.
+ */
+typedef struct {
+    uint32_t magic;         /**< SEEKIDX_MAGIC */
+    uint32_t frames;        /**< number of frames of the track */
+    uint16_t frame_samples; /**< samples per channel of one frame */
+    uint16_t reserved;      /**< reserved, 0 */
+    uint32_t samplerate;    /**< sample rate in Hz */
+} seekidx_hdr_t;
+
+/**
+ * @brief Offsets of SEEKIDX_GROUP frames
+ *
+ * Frame 0 of the group starts at base, frame n at base plus the sizes
+ * delta[0] ... delta[n - 1] of the frames before.
+ */
+typedef struct {
+    uint32_t base;                      /**< offset from the track start */
+    uint16_t delta[SEEKIDX_GROUP - 1];  /**< sizes of the frames 0 - 14 */
+    uint16_t reserved;                  /**< reserved, 0 */
+} seekidx_group_t;
+
+/**
+ * @brief Calculates the checksum over the used entries
+ *
+ * @param[in] *dir      directory
+ *
+ * @return              complemented sum of all 32 bit words of the entries
+ */
+static inline uint32_t trackdir_checksum(const trackdir_t *dir)
+{
+    const uint32_t *word = (const uint32_t *)dir->entry;
+    uint32_t words = (uint32_t)dir->count * (sizeof(trackdir_entry_t) / 4);
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        sum += word[i];
+    }
+
+    return ~sum;
+}
+
+/**
+ * @brief Checks magic, version, checksum and bounds of all entries
+ *
+ * @param[in] *dir      directory as read from TRACKDIR_ADDR
+ *
+ * @return 0 on success / ERROR_x on error (see defines)
+ */
+int trackdir_check(const trackdir_t *dir);
+
+/**
+ * @brief Returns an entry of the directory
+ *
+ * @param[in] *dir      directory
+ * @param[in] n         number of the track, starting with 0
+ *
+ * @return              the entry or NULL if there is no such track
+ */
+const trackdir_entry_t *trackdir_get(const trackdir_t *dir, int n);
+
+/**
+ * @brief Fills a directory with the fixed tracks of old flash images
+ *
+ * Used if the flash holds no directory: two tracks of 2MB at 0x000000 and
+ * 0x200000, padding is skipped by the decoder.
+ *
+ * @param[in] *dir      directory to fill
+ */
+void trackdir_legacy(trackdir_t *dir);
+
+#endif /* TRACKDIR_H */
@@ -0,0 +1,381 @@
+/**
+ * @{
+ *
+ * @brief     Upload of new flash content over the UART during playback
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "include/ingest.h"
+#include "driver/uart.h"
+#include "driver/crc.h"
+#include "driver/at25df641.h"
+#include "driver/define/at25df641_def.h"
+
+/** Device which receives the upload, the playback reads the other one */
+#define INGEST_DEV      (AT25DF641_0)
+/** Device which is made equal to INGEST_DEV by a commit */
+#define COMMIT_DEV      (AT25DF641_1)
+/** Size of the receive ring */
+#define RING_SIZE       (INGEST_CHUNKS * INGEST_CHUNK)
+/** Queued erases, the running one and the one ahead */
+#define ERASES          (2)
+/** Bytes of a WRITE command */
+#define CMD_WRITE_SIZE  (9)
+
+/** States of the upload */
+#define S_IDLE          (0) /**< waiting for a command */
+#define S_DATA          (1) /**< receiving the data of a WRITE */
+
+/** Receive ring, the chunks are programmed from here, word aligned for the CRC unit */
+static uint32_t ring[RING_SIZE / 4];
+
+/**
+ * @brief State of the upload
+ */
+static struct {
+    int state;                          /**< S_x */
+    uint16_t rx_pos;                    /**< last DMA position in the ring */
+    uint32_t addr;                      /**< flash address of the WRITE */
+    uint32_t len;                       /**< number of bytes of the WRITE */
+    uint32_t received;                  /**< received bytes */
+    uint32_t submitted;                 /**< bytes queued for programming */
+    uint32_t erased;                    /**< end of the queued erases */
+    uint32_t credited;                  /**< chunks granted to the host */
+    uint32_t chunks;                    /**< chunks of the WRITE */
+    uint32_t erases;                    /**< queued erases */
+    uint32_t crc;                       /**< CRC of the queued data */
+    uint32_t lo, hi;                    /**< range written since the last commit */
+    volatile uint32_t programmed;       /**< finished chunks */
+    volatile uint32_t erases_done;      /**< finished erases */
+    volatile int status;                /**< first error of the transactions */
+    at25df641_trans_t write[INGEST_CHUNKS]; /**< one transaction per chunk */
+    at25df641_trans_t erase[ERASES];    /**< erases ahead of the chunks */
+} ing;
+
+/**
+ * @brief Callback of the chunks, from interrupt context
+ */
+static void _write_done(void *arg, int status)
+{
+    (void)arg;
+
+    if (status != OK)
+    {
+        ing.status = status;
+    }
+
+    ing.programmed++;
+}
+
+/**
+ * @brief Callback of the erases, from interrupt context
+ */
+static void _erase_done(void *arg, int status)
+{
+    (void)arg;
+
+    if (status != OK)
+    {
+        ing.status = status;
+    }
+
+    ing.erases_done++;
+}
+
+/**
+ * @brief Answers with a reply byte and a 32 bit value or the status
+ */
+static void _reply(unsigned char reply, uint32_t value)
+{
+    unsigned char buf[5];
+
+    buf[0] = reply;
+    buf[1] = (unsigned char)value;
+    buf[2] = (unsigned char)(value >> 8);
+    buf[3] = (unsigned char)(value >> 16);
+    buf[4] = (unsigned char)(value >> 24);
+
+    uart_write(UART_0, buf, (reply == INGEST_REPLY_OK) ? 5 : 2);
+}
+
+/**
+ * @brief Returns the number of bytes the DMA wrote since the last call
+ */
+static uint32_t _rx_new(void)
+{
+    uint16_t pos = uart_rx_pos(UART_0);
+    uint32_t n = (pos + RING_SIZE - ing.rx_pos) % RING_SIZE;
+
+    ing.rx_pos = pos;
+
+    return n;
+}
+
+/**
+ * @brief Queues the erases til one block ahead of the given address
+ *
+ * @return              1 if the address is covered by queued erases
+ */
+static int _erase_ahead(uint32_t addr)
+{
+    uint32_t end = ing.addr + ing.len;
+    uint32_t target = addr + INGEST_BLOCK;
+    at25df641_trans_t *trans;
+
+    target = (target < end) ? target : end;
+
+    while ((ing.erased < target) && ((ing.erases - ing.erases_done) < ERASES))
+    {
+        trans = &ing.erase[ing.erases % ERASES];
+        memset(trans, 0, sizeof *trans);
+        trans->type = TRANS_ERASE;
+        trans->prio = PRIO_BACKGROUND;
+        trans->dev = INGEST_DEV;
+        trans->erase_cmd = BLOCK_ERASE_64KB;
+        trans->addr = ing.erased;
+        trans->cb = _erase_done;
+
+        ing.erases++;
+
+        if (at25df641_submit(trans) != OK)
+        {
+            ing.erases_done++;
+            ing.status = ERROR_DEFAULT;
+        }
+
+        ing.erased += INGEST_BLOCK;
+    }
+
+    return (ing.erased >= addr);
+}
+
+/**
+ * @brief Queues the received chunks and the tail at the end
+ */
+static void _submit_chunks(void)
+{
+    at25df641_trans_t *trans;
+    unsigned char *data;
+    uint32_t n;
+
+    while (ing.submitted < ing.received)
+    {
+        n = ing.len - ing.submitted;
+        n = (n < INGEST_CHUNK) ? n : INGEST_CHUNK;
+
+        /* wait for a whole chunk, the erase of its block has to go first */
+        if (((ing.received - ing.submitted) < n) || !_erase_ahead(ing.addr + ing.submitted + n))
+        {
+            return;
+        }
+
+        data = (unsigned char *)ring + (ing.submitted % RING_SIZE);
+        ing.crc = (ing.submitted == 0) ? crc_calc(data, n) : crc_update(data, n);
+
+        trans = &ing.write[(ing.submitted / INGEST_CHUNK) % INGEST_CHUNKS];
+        memset(trans, 0, sizeof *trans);
+        trans->type = TRANS_WRITE;
+        trans->prio = PRIO_BACKGROUND;
+        trans->dev = INGEST_DEV;
+        trans->data = data;
+        trans->addr = ing.addr + ing.submitted;
+        trans->size = n;
+        trans->cb = _write_done;
+
+        ing.submitted += n;
+
+        if (at25df641_submit(trans) != OK)
+        {
+            ing.programmed++;
+            ing.status = ERROR_DEFAULT;
+        }
+    }
+}
+
+/**
+ * @brief Grants the host the room of the free chunks
+ */
+static void _credit(void)
+{
+    static const unsigned char credit = INGEST_REPLY_CREDIT;
+
+    /* one chunk stays unused, so the DMA never laps the reader */
+    while ((ing.credited < ing.chunks) &&
+           (ing.credited < (ing.programmed + INGEST_CHUNKS - 1)))
+    {
+        uart_write(UART_0, &credit, 1);
+        ing.credited++;
+    }
+}
+
+/**
+ * @brief Starts a WRITE, checks the range and queues the first erases
+ */
+static void _start_write(const unsigned char *cmd)
+{
+    ing.addr = (uint32_t)cmd[1] | ((uint32_t)cmd[2] << 8) | ((uint32_t)cmd[3] << 16) |
+               ((uint32_t)cmd[4] << 24);
+    ing.len = (uint32_t)cmd[5] | ((uint32_t)cmd[6] << 8) | ((uint32_t)cmd[7] << 16) |
+              ((uint32_t)cmd[8] << 24);
+
+    if ((ing.addr % INGEST_BLOCK) || (ing.len == 0) || (ing.addr >= AT25DF641_MEM_SIZE) ||
+        (ing.len > (AT25DF641_MEM_SIZE - ing.addr)))
+    {
+        _reply(INGEST_REPLY_ERROR, (uint32_t)ERROR_OUT_OF_BOUND);
+        return;
+    }
+
+    ing.state = S_DATA;
+    ing.received = 0;
+    ing.submitted = 0;
+    ing.erased = ing.addr;
+    ing.credited = 0;
+    ing.chunks = (ing.len + INGEST_CHUNK - 1) / INGEST_CHUNK;
+    ing.erases = 0;
+    ing.erases_done = 0;
+    ing.programmed = 0;
+    ing.status = OK;
+
+    if (ing.hi == 0)
+    {
+        ing.lo = ing.addr;
+    }
+
+    ing.lo = (ing.addr < ing.lo) ? ing.addr : ing.lo;
+    ing.hi = ((ing.addr + ing.len) > ing.hi) ? (ing.addr + ing.len) : ing.hi;
+
+    /* the data starts at the begin of the ring, aligned to the chunks */
+    uart_rx_start(UART_0, (unsigned char *)ring, RING_SIZE);
+    ing.rx_pos = 0;
+
+    _erase_ahead(ing.addr);
+    _credit();
+}
+
+int ingest_init(void)
+{
+    memset(&ing, 0, sizeof ing);
+    crc_init();
+
+    if ((uart_init(UART_0, INGEST_BAUD) != 0) ||
+        (uart_rx_start(UART_0, (unsigned char *)ring, RING_SIZE) != 0))
+    {
+        return ERROR_DEFAULT;
+    }
+
+    return OK;
+}
+
+int ingest_poll(void)
+{
+    unsigned char cmd[CMD_WRITE_SIZE];
+    unsigned char *p = (unsigned char *)ring;
+    uint32_t n, i;
+
+    if (ing.state == S_DATA)
+    {
+        n = _rx_new();
+        ing.received += n;
+        ing.received = (ing.received < ing.len) ? ing.received : ing.len;
+
+        _submit_chunks();
+        _credit();
+
+        if ((ing.submitted == ing.len) && (ing.programmed == ing.chunks) &&
+            (ing.erases_done == ing.erases))
+        {
+            if (ing.status == OK)
+            {
+                _reply(INGEST_REPLY_OK, ing.crc);
+            }
+            else
+            {
+                _reply(INGEST_REPLY_ERROR, (uint32_t)ing.status);
+            }
+
+            ing.state = S_IDLE;
+            uart_rx_start(UART_0, (unsigned char *)ring, RING_SIZE);
+            ing.rx_pos = 0;
+        }
+
+        return INGEST_EV_NONE;
+    }
+
+    /* a command is complete if all its bytes are there */
+    n = (uart_rx_pos(UART_0) + RING_SIZE - ing.rx_pos) % RING_SIZE;
+
+    if (n == 0)
+    {
+        return INGEST_EV_NONE;
+    }
+
+    cmd[0] = p[ing.rx_pos];
+
+    if (cmd[0] == INGEST_CMD_COMMIT)
+    {
+        _rx_new();
+        return INGEST_EV_COMMIT;
+    }
+
+    if (cmd[0] != INGEST_CMD_WRITE)
+    {
+        /* drop unknown bytes */
+        ing.rx_pos = (ing.rx_pos + 1) % RING_SIZE;
+        return INGEST_EV_NONE;
+    }
+
+    if (n < CMD_WRITE_SIZE)
+    {
+        return INGEST_EV_NONE;
+    }
+
+    for (i = 0; i < CMD_WRITE_SIZE; i++)
+    {
+        cmd[i] = p[(ing.rx_pos + i) % RING_SIZE];
+    }
+
+    _start_write(cmd);
+
+    if (ing.state != S_DATA)
+    {
+        ing.rx_pos = (ing.rx_pos + CMD_WRITE_SIZE) % RING_SIZE;
+        return INGEST_EV_NONE;
+    }
+
+    return INGEST_EV_WRITE;
+}
+
+int ingest_busy(void)
+{
+    return (ing.state == S_DATA);
+}
+
+int ingest_commit(void)
+{
+    int status = OK;
+
+    if (ing.hi > ing.lo)
+    {
+        status = at25df641_sync_range(COMMIT_DEV, INGEST_DEV, ing.lo, ing.hi - ing.lo, NULL);
+    }
+
+    if (status == OK)
+    {
+        ing.lo = 0;
+        ing.hi = 0;
+        _reply(INGEST_REPLY_OK, 0);
+    }
+    else
+    {
+        _reply(INGEST_REPLY_ERROR, (uint32_t)status);
+    }
+
+    return status;
+}
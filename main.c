@@ -1,368 +1,1093 @@
-/**
- * @{
- *
- * @brief     Main application for the mp3 player.
- * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
- * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
- *
- * @}
- */
-
-#include <stdio.h>
-#include <stdint.h>
-#include <stm32f4xx.h>
-#include <string.h>
-
-/** HAW-TI-LAB libraries */
-#include "CE_Lib.h"
-#include "tft.h"
-
-/** Application helper */
-#define ARM_ADS
-#include "include/mp3dec.h"
-#include "include/audiocalc.h"
-#include "include/periph_access.h"
-#include "include/fsmc.h"
-
-/** Low-level peripheral driver */
-#include "driver/pwm.h"
-#include "driver/dac.h"
-#include "driver/timer.h"
-#include "driver/gpio.h"
-#include "driver/at25df641.h"
-#include "driver/spi.h"
-
-/** Commando macros for memory */
-#include "driver/define/at25df641_def.h"
-
-/** Configuration of all peripherie */
-#include "driver/config/periph_conf.h"
-
-/** Application macros */
-#define TFT_EN          (1)
-#define MSEC_DIVIDER    (SYS_FREQ / 1000)
-#define FIFO_BUFF_SIZE  (MAX_NCHAN * MAX_NGRAN * MAX_NSAMP)
-#define LEFT_CHANNEL    (0)
-#define RIGHT_CHANNEL   (1)
-#define OUTPUT_AMP			(181) // amplification of the signal to reach original scale, sqrt(32768) = 181
-
-/** Fifo declarations */
-typedef struct {
-    int16_t data[FIFO_BUFF_SIZE]; /**< data of fifo */
-    uint16_t index;               /**< Current index of the buffer */
-    uint8_t full;                 /**< Flag if buffer is full */
-} fifo_t;
-
-static volatile fifo_t fifo_0;    /**< first buffer */
-static volatile fifo_t fifo_1;    /**< second buffer */
-static volatile fifo_t *bg_buf;   /**< pointer to bgBuffer */
-static volatile fifo_t *isr_buf;  /**< pointer to isrBuffer */
-
-/** Misc */
-static volatile int tft_refresh;  /**< flag to refresh the display */
-static volatile uint32_t counter; /**< counts the number of outputs */
-static uint32_t address;
-static int forever = 0;
-
-/*****************************************************************************
- * @brief Resets all relevant variables used for a new program start         *
- *****************************************************************************/
-static void _reset_var(void)
-{
-    forever = 1;
-    address = 0;
-    tft_refresh = 0;
-    counter = 0;
-}
-
-/*****************************************************************************
- * @brief Prints runtime informations to the tft-display.                    *
- *                                                                           *
- * @detail Calculates the runtime in milliseconds by multiplying the counter *
- *         value with the value from the auto-reload-register and then       *
- *         divide it with the System frequency divided by thousand.          *
- *****************************************************************************/
-static void _lcd_out()
-{
-    char tmp[sizeof(int) * 3 + 2];
-    uint32_t msec = (counter * TIMER_0_ARR) / MSEC_DIVIDER;
-
-    snprintf(tmp, sizeof tmp, "%d", msec);
-    TFT_gotoxy(15, 4);
-    TFT_puts("msec:");
-    TFT_gotoxy(21, 5);
-    TFT_puts(tmp);
-    snprintf(tmp, sizeof tmp, "%d", counter);
-    TFT_gotoxy(15, 7);
-    TFT_puts("count:");
-    TFT_gotoxy(21, 8);
-    TFT_puts(tmp);
-}
-
-/*****************************************************************************
- * @brief Check the buttons for change the starting address                  *
- *                                                                           *
- * @detail Check via macro if button S1 or S2 is pressed.                    *
- *         When S1 is pressed, reset the data address to 0x000000 and start. *
- *         When S2 is pressed, Set the data address to 0x200000 and start.   *
- *****************************************************************************/
-static void _check_buttons(unsigned char *mem_data)
-{
-    if (S1)
-    {
-        _reset_var();
-        address = 0x000000;
-        at25df641_read(AT25DF641_1, mem_data, MAINBUF_SIZE, address);
-        address += MAINBUF_SIZE;
-    }
-
-    if (S2)
-    {
-        _reset_var();
-        address = 0x200000;
-        at25df641_read(AT25DF641_1, mem_data, MAINBUF_SIZE, address);
-        address += MAINBUF_SIZE;
-    }
-}
-
-/*****************************************************************************
- * @brief Moves the data in the memory for next operations                   *
- *                                                                           *
- * @detail TODO                                                              *
- *****************************************************************************/
-static void _update_memory(unsigned char *data, unsigned char *data_ptr, int bytes_left)
-{
-    memcpy(data, data_ptr, bytes_left);
-    at25df641_read(AT25DF641_1, &data[bytes_left], MAINBUF_SIZE - bytes_left, address);
-    address += (MAINBUF_SIZE - bytes_left);
-}
-
-/*****************************************************************************
- * @brief Transfer data trough the FSMC.                                     *
- *                                                                           *
- * @detail Takes a single 16 bit data and send it trough the FSMC interface  *
- *         as a write operation. Then wait for the FPGA RDY signal (NWAIT)   *
- *         to read the encoded data. At last overwrite the old data with     *
- *         the new one.                                                      *
- *****************************************************************************/
-static inline void _fsmc(void)
-{
-    int i;
-    int16_t tmp;
-
-    for (i = 0; i < FIFO_BUFF_SIZE; i++)
-    {
-        /* write to FPGA via FSMC */
-        fsmc_transfer(bg_buf->data[i], NULL);
-        /* read from FPGA via FSMC */
-        fsmc_transfer(NULL, &tmp);
-        bg_buf->data[i] = tmp * OUTPUT_AMP;
-    }
-}
-
-/*****************************************************************************
- * @brief INTERUPT-SERVICE-ROUTINE                                           *
- *                                                                           *
- * @detail First check if the isr_buf is not empty, set the LED on PH11,     *
- *         when the buffer is full or clear it when it is empty.             *
- *                                                                           *
- *         Calculate four values, two for each peripheral output             *
- *         for each of the two channels. Each channel belongs to their       *
- *         own physically output, one for left and one for the right.        *
- *                                                                           *
- *         Writes the calculated value to the corresponding peripherial      *
- *         output.                                                           *
- *                                                                           *
- *         The index increments by two.                                      *
- *         The counter counts also four times for four calculated outputs    *
- *                                                                           *
- *         Next check if the buffer has reached his end.                     *
- *         When true, reset the buffers values and change the buffer.        *
- *         When false, end the ISR and wait for the next routine             *
- *****************************************************************************/
-static void isr (void)
-{
-    uint16_t dac_left;
-    uint16_t dac_right;
-    uint16_t pwm_left;
-    uint16_t pwm_right;
-
-    if (!isr_buf->full)
-    {
-        SET_PH11();
-    }
-    else
-    {
-        CLR_PH11();
-
-        dac_left = calc_dac(isr_buf->data[isr_buf->index]);
-        dac_right = calc_dac(isr_buf->data[isr_buf->index + 1]);
-        pwm_left = calc_pwm(isr_buf->data[isr_buf->index]);
-        pwm_right = calc_pwm(isr_buf->data[isr_buf->index + 1]);
-
-        dac_write(DAC_0, LEFT_CHANNEL, dac_left);
-        dac_write(DAC_0, RIGHT_CHANNEL, dac_right);
-        pwm_set(PWM_0, LEFT_CHANNEL, pwm_left);
-        pwm_set(PWM_0, RIGHT_CHANNEL, pwm_right);
-
-        isr_buf->index += 2;
-        counter += 4;
-
-        if (isr_buf->index >= FIFO_BUFF_SIZE)
-        {
-            isr_buf->index = 0;
-            isr_buf->full = 0;
-
-            if (isr_buf == &fifo_0)
-            {
-                isr_buf = &fifo_1;
-            }
-            else
-            {
-                isr_buf = &fifo_0;
-            }
-        }
-    } /* else */
-}
-
-/*****************************************************************************
- * @brief TFT Service routine                                                *
- *                                                                           *
- * @detail Sets a flag, which signals that the display should be refreshed   *
- *****************************************************************************/
-static void tft (void)
-{
-    tft_refresh = 1;
-}
-
-/*****************************************************************************
- * @brief Main application                                                   *
- *                                                                           *
- * @detail TODO                                                              *
- *****************************************************************************/
-int main(void)
-{
-    HMP3Decoder mp3Decoder = NULL;
-    int skip_bytes;
-    int	bytes_left = MAINBUF_SIZE;
-    int	status;
-    unsigned char mem_data[MAINBUF_SIZE];
-    unsigned char *mem_data_ptr = mem_data;
-
-    /* Need to initialize the CEP-TI-LAB-BOARD */
-    initCEP_Board();
-    _reset_var();
-
-    /* Initialize both buffer */
-    fifo_0.full = 0;
-    fifo_0.index = 0;
-    fifo_1.full = 0;
-    fifo_1.index = 0;
-
-    /* Set both pointer to first buffer */
-    bg_buf = &fifo_0;
-    isr_buf = &fifo_0;
-
-    /* Enable all needed GPIO clocks */
-    GPIOA_CLKEN();
-    GPIOC_CLKEN();
-    GPIOF_CLKEN();
-    GPIOH_CLKEN();
-    GPIOI_CLKEN();
-    WORK_CS_PORT_CLKEN();
-    ORIG_CS_PORT_CLKEN();
-
-    /* Initialize all needed peripheral low-level drivers */
-    fsmc_init();                                  /**< FSMC interface */
-    timer_init(TIMER_0, isr);                     /**< PWM Output timer */
-    timer_init(TIMER_1, tft);                     /**< TFT Output timer */
-    dac_init(DAC_0);                              /**< DAC (PA4) Analog Output */
-    spi_init_master(SPI_0, SPI_BAUD_42MHZ_DIV_2); /**< SPI3 with 21 MHz */
-    at25df641_init(AT25DF641_1);                  /**< init work memory */
-    gpio_init(GPIO_DIR_OUT, GPIOI, PI7);          /**< D23 */
-    gpio_init(GPIO_DIR_OUT, GPIOH, PH11);         /**< Underflow-LED */
-    gpio_init(GPIO_DIR_OUT, GPIOI, PI6);          /**< D22 */
-    gpio_init(GPIO_DIR_OUT, GPIOH, PH13);         /**< Wait-LED */
-
-    /* Fills the memory buffer for the first time */
-    at25df641_read(AT25DF641_1, mem_data, MAINBUF_SIZE, address);
-    address += MAINBUF_SIZE;
-
-    /* Initialize a new mp3 decoder */
-    if ((mp3Decoder = MP3InitDecoder()) == 0) {
-        perror("MP3InitDecoder() [ FAIL ]\n");
-        return 1;
-    }
-
-    /* Main loop */
-    while (1)
-    {
-        /*********************************************************************
-         * @detail MP3 Play loop.                                            *
-         *         1. Find the next word of the track                        *
-         *         2. Set the LED PH13 and wait til background buffer is     *
-         *            empty                                                  *
-         *         3. Clear the LED PH13, because background buffer is empty *
-         *         4. Decodes a new frame                                    *
-         *         5. Starts the FSMC module                                 *
-         *         6. Marks background buffer as full                        *
-         *         7. Set the bg_buf pointer to another buffer               *
-         *         8. Clean up the memory                                    *
-         *         9. [Optional] check buttons when playing                  *
-         *********************************************************************/
-        while (forever)
-        {
-#if TFT_EN
-            if (tft_refresh)
-            {
-                _lcd_out();
-                tft_refresh = 0;
-            }
-#endif
-            bytes_left = MAINBUF_SIZE;
-            mem_data_ptr = mem_data;
-
-            if ((skip_bytes = MP3FindSyncWord(mem_data, MAINBUF_SIZE)) > 0)
-            {
-                printf("Bytes skipped: %d\n", skip_bytes);
-                address += skip_bytes;
-                _update_memory(mem_data, mem_data_ptr, skip_bytes);
-            }
-            else if (skip_bytes < 0)
-            {
-                printf("MP3FindSyncWord() [ FAIL ]\n");
-                forever = 0;
-                break;
-            }
-
-            SET_PH13();
-            while(bg_buf->full);
-            CLR_PH13();
-
-            if ((status = MP3Decode(mp3Decoder, &mem_data_ptr, &bytes_left, (short *)bg_buf->data, 0)) < 0)
-            {
-                printf("MP3Decode() [ ERROR %d ]\n", status);
-                forever = 0;
-                break;
-            }
-
-            _fsmc();
-
-            bg_buf->full = 1;
-
-            if (bg_buf == &fifo_0) {
-                bg_buf = &fifo_1;
-            }
-            else {
-                bg_buf = &fifo_0;
-            }
-
-            _update_memory(mem_data, mem_data_ptr, bytes_left);
-            _check_buttons(mem_data);
-        }  /* while (forever) */
-
-        _check_buttons(mem_data);
-    }  /* while (1) */
-
-    return 0; // Never reached.
-}
+/**
+ * @{
+ *
+ * @brief     Main application for the mp3 player.
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stm32f4xx.h>
+#include <string.h>
+
+/** HAW-TI-LAB libraries */
+#include "CE_Lib.h"
+#include "tft.h"
+
+/** Application helper */
+#define ARM_ADS
+#include "include/mp3dec.h"
+#include "include/audiocalc.h"
+#include "include/periph_access.h"
+#include "include/fsmc.h"
+#include "include/bench.h"
+#include "include/inbuf.h"
+#include "include/readahead.h"
+#include "include/trackdir.h"
+#include "include/seekidx.h"
+#include "include/pcmcache.h"
+#include "include/pcmdec.h"
+#include "include/ingest.h"
+#include "include/stream.h"
+#include "include/prof.h"
+
+/** Low-level peripheral driver */
+#include "driver/pwm.h"
+#include "driver/dac.h"
+#include "driver/timer.h"
+#include "driver/gpio.h"
+#include "driver/at25df641.h"
+#include "driver/spi.h"
+
+/** Commando macros for memory */
+#include "driver/define/at25df641_def.h"
+
+/** Configuration of all peripherie */
+#include "driver/config/periph_conf.h"
+
+/** Application macros */
+#define TFT_EN          (1)
+#define BENCH_EN        (0)
+#define INGEST_EN       (1) // upload of new content over UART_0
+#define STREAM_EN       (1) // live MP3 stream over UART_1
+#define PROF_EN         (0) // cycles of the play loop stages per frame
+#define BENCH_ADDR      (TRACKDIR_ADDR - AT25DF641_BLOCK_SIZE) // scratch block of the work chip
+#define SPI_WIRE_FREQ   (21000000) // SPI3 with SPI_BAUD_42MHZ_DIV_2
+#define MSEC_DIVIDER    (SYS_FREQ / 1000)
+#define GRANULE_SIZE    (MAX_NCHAN * MAX_NSAMP) // samples of one fifo slot, half a stereo MPEG-1 frame
+#define FIFO_SLOTS      (2 * MAX_NGRAN) // two full frames, a frame fills neighbouring slots
+#define FIFO_BUFF_SIZE  (MAX_NGRAN * GRANULE_SIZE) // samples of one frame
+#define LEFT_CHANNEL    (0)
+#define RIGHT_CHANNEL   (1)
+#define SKIP_MSEC       (10000) // skip distance of a second press of the track button
+#define PCMCACHE_MODE   (PCMCACHE_ALL) // decoded track starts on the work memory
+#define OUTPUT_AMP			(181) // amplification of the signal to reach original scale, sqrt(32768) = 181
+
+/** Fifo declarations, one slot holds GRANULE_SIZE samples */
+typedef struct {
+    volatile int16_t *data;       /**< data of the slot in fifo_data */
+    uint16_t index;               /**< Current index of the slot */
+    uint16_t len;                 /**< number of samples, 0 for an empty slot */
+    uint8_t full;                 /**< Flag if slot is full */
+} fifo_t;
+
+static volatile int16_t fifo_data[FIFO_SLOTS * GRANULE_SIZE]; /**< samples of all slots */
+static volatile fifo_t fifo[FIFO_SLOTS]; /**< ring of slots */
+static volatile fifo_t *bg_buf;   /**< pointer to bgBuffer */
+static volatile fifo_t *isr_buf;  /**< pointer to isrBuffer */
+static volatile int fifo_flush;   /**< flag to drop all slots, cleared by the ISR */
+
+/** Misc */
+static volatile int tft_refresh;  /**< flag to refresh the display */
+static volatile uint32_t counter; /**< counts the number of outputs */
+static inbuf_t mem;               /**< decoder input, not on stack for DMA */
+static trackdir_t dir;            /**< track directory of the flash */
+static seekidx_t idx;             /**< seek index of the current track */
+static int idx_ok;                /**< flag if the current track has an index */
+static int cur_track;             /**< number of the current track */
+static uint32_t cur_frame;        /**< number of the next decoded frame */
+static int preroll;               /**< frames to decode without output */
+static int resync;                /**< flag if the decoder starts behind a seek */
+static int pcm_frames;            /**< cached frames of the track start */
+static int pcm_next;              /**< next cached frame to replay */
+static int cur_format;            /**< encoding of the current track */
+static pcmdec_t pcm;              /**< decoder of PCM and ADPCM tracks */
+static int pcm_need;              /**< input bytes of one output buffer */
+static uint64_t load_cycles[TRACKDIR_FMT_ADPCM + 1]; /**< decoding cycles per format */
+static uint32_t load_samples[TRACKDIR_FMT_ADPCM + 1]; /**< decoded samples per format */
+static int streaming;             /**< flag if the decoder plays the live stream */
+#if PROF_EN
+static uint32_t prof_mark;        /**< cycle counter at the end of the last stage */
+#endif
+static int forever = 0;
+
+/*****************************************************************************
+ * @brief Resets all relevant variables used for a new program start         *
+ *****************************************************************************/
+static void _reset_var(void)
+{
+    forever = 1;
+    tft_refresh = 0;
+    counter = 0;
+#if PROF_EN
+    prof_reset();
+#endif
+}
+
+/*****************************************************************************
+ * @brief Starts the time of the first stage of the play loop [PROF_EN]      *
+ *****************************************************************************/
+static inline void _prof_mark(void)
+{
+#if PROF_EN
+    prof_mark = bench_cycles();
+#endif
+}
+
+/*****************************************************************************
+ * @brief Adds the cycles since the last stage to the given stage [PROF_EN]  *
+ *****************************************************************************/
+static inline void _prof(int stage)
+{
+#if PROF_EN
+    uint32_t now = bench_cycles();
+
+    prof_add(stage, now - prof_mark);
+    prof_mark = now;
+#endif
+}
+
+/*****************************************************************************
+ * @brief Closes the frame of the stage times [PROF_EN]                      *
+ *                                                                           *
+ * @detail Called per output frame. Preroll and dropped frames count to the  *
+ *         next output frame.                                                *
+ *****************************************************************************/
+static inline void _prof_frame(void)
+{
+#if PROF_EN
+    prof_frame();
+#endif
+}
+
+/*****************************************************************************
+ * @brief Drops the output which is not played yet                           *
+ *                                                                           *
+ * @detail The ISR empties all slots at its next sample and restarts at the  *
+ *         first slot, so a new track starts without the queued samples of   *
+ *         the old one.                                                      *
+ *****************************************************************************/
+static void _flush_fifo(void)
+{
+    fifo_flush = 1;
+    while (fifo_flush);
+    bg_buf = &fifo[0];
+}
+
+/*****************************************************************************
+ * @brief Prints runtime informations to the tft-display.                    *
+ *                                                                           *
+ * @detail Calculates the runtime in milliseconds by multiplying the counter *
+ *         value with the value from the auto-reload-register and then       *
+ *         divide it with the System frequency divided by thousand.          *
+ *****************************************************************************/
+static void _lcd_out()
+{
+    char tmp[sizeof(int) * 3 + 2];
+    uint32_t msec = (counter * TIMER_0_ARR) / MSEC_DIVIDER;
+    uint32_t load;
+    uint32_t wait = readahead_underruns();
+#if STREAM_EN
+    stream_stats_t stats;
+
+    if (streaming)
+    {
+        stream_stats(&stats);
+        wait = stats.underruns;
+        snprintf(tmp, sizeof tmp, "%u", stats.fill_ms);
+        TFT_gotoxy(15, 16);
+        TFT_puts("buf:");
+        TFT_gotoxy(21, 17);
+        TFT_puts(tmp);
+    }
+#endif
+
+    snprintf(tmp, sizeof tmp, "%d", msec);
+    TFT_gotoxy(15, 4);
+    TFT_puts("msec:");
+    TFT_gotoxy(21, 5);
+    TFT_puts(tmp);
+    snprintf(tmp, sizeof tmp, "%d", counter);
+    TFT_gotoxy(15, 7);
+    TFT_puts("count:");
+    TFT_gotoxy(21, 8);
+    TFT_puts(tmp);
+    snprintf(tmp, sizeof tmp, "%u", wait);
+    TFT_gotoxy(15, 10);
+    TFT_puts("wait:");
+    TFT_gotoxy(21, 11);
+    TFT_puts(tmp);
+    load = bench_load(load_cycles[cur_format], load_samples[cur_format], TIMER_FREQ);
+    snprintf(tmp, sizeof tmp, "%u.%u%%", load / 10, load % 10);
+    TFT_gotoxy(15, 13);
+    TFT_puts("cpu:");
+    TFT_gotoxy(21, 14);
+    TFT_puts(tmp);
+}
+
+/*****************************************************************************
+ * @brief Prints the decoding cost of all played formats                     *
+ *                                                                           *
+ * @detail The cycles of the decoder calls are summed up per track format,   *
+ *         waiting for the flash or the output is not counted.               *
+ *****************************************************************************/
+static void _report_load(void)
+{
+    static const char *format_name[] = {"MP3", "PCM16", "IMA-ADPCM"};
+    int format;
+
+    for (format = TRACKDIR_FMT_MP3; format <= TRACKDIR_FMT_ADPCM; format++)
+    {
+        bench_report_load(format_name[format], load_cycles[format], load_samples[format],
+                          TIMER_FREQ);
+    }
+
+#if PROF_EN
+    prof_report(SYS_FREQ);
+#endif
+}
+
+/*****************************************************************************
+ * @brief Loads the track directory from the flash                           *
+ *                                                                           *
+ * @detail Falls back to the two fixed tracks of old flash images, if the    *
+ *         flash holds no valid directory.                                   *
+ *****************************************************************************/
+static void _load_dir(void)
+{
+    if ((at25df641_read(AT25DF641_1, (unsigned char *)&dir, sizeof dir, TRACKDIR_ADDR) != OK) ||
+        (trackdir_check(&dir) != OK))
+    {
+        printf("No track directory, using fixed tracks\n");
+        trackdir_legacy(&dir);
+    }
+}
+
+/*****************************************************************************
+ * @brief Starts a track of the directory                                    *
+ *                                                                           *
+ * @detail Drops the old memory content and starts the read-ahead directly   *
+ *         at the first frame of the track. Waits for the first block of     *
+ *         the decoder.                                                      *
+ *                                                                           *
+ *         If the start of the track is in the PCM cache, it is replayed and *
+ *         the decoder seeks behind it, like for a skip.                     *
+ *                                                                           *
+ *         PCM and ADPCM tracks start behind their WAV header and have no    *
+ *         seek index.                                                       *
+ *****************************************************************************/
+static int _open_track(int n)
+{
+    const trackdir_entry_t *track;
+    uint32_t offset;
+    int status;
+
+    if ((track = trackdir_get(&dir, n)) == NULL)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    _flush_fifo();
+    cur_track = n;
+    cur_frame = 0;
+    preroll = 0;
+    resync = 0;
+    pcm_next = 0;
+
+    if (track->format != TRACKDIR_FMT_MP3)
+    {
+        idx_ok = 0;
+        pcm_frames = 0;
+
+        if ((status = pcmdec_open(&pcm, AT25DF641_1, track)) != OK)
+        {
+            printf("pcmdec_open() [ ERROR %d ]\n", status);
+            return status;
+        }
+
+        /* one output slot plus a block, which may be cut by the slot */
+        cur_format = track->format;
+        pcm_need = (int)(((int64_t)pcm.bitrate * (GRANULE_SIZE / 2)) / (8 * TIMER_FREQ)) +
+                   pcm.block_align;
+        readahead_start(&mem, AT25DF641_1, track->offset + track->first_frame,
+                        track->length - track->first_frame);
+        readahead_wait(pcm_need);
+
+        return OK;
+    }
+
+    cur_format = TRACKDIR_FMT_MP3;
+    idx_ok = (seekidx_open(&idx, AT25DF641_1, track) == OK);
+    pcm_frames = pcmcache_open(n, track);
+
+    if ((pcm_frames > 0) && idx_ok && (seekidx_seek(&idx, pcm_frames, &offset, &preroll) == OK))
+    {
+        cur_frame = pcm_frames - preroll;
+        resync = 1;
+        readahead_start(&mem, AT25DF641_1, track->offset + offset, track->length - offset);
+    }
+    else
+    {
+        pcm_frames = 0;
+        readahead_start(&mem, AT25DF641_1, track->offset + track->first_frame,
+                        track->length - track->first_frame);
+    }
+
+    readahead_wait(MAINBUF_SIZE);
+
+    return OK;
+}
+
+/*****************************************************************************
+ * @brief Jumps to a time position of the current track                      *
+ *                                                                           *
+ * @detail Looks up the frame in the seek index and restarts the read-ahead  *
+ *         at the first frame of the bit reservoir. The output of these      *
+ *         preroll frames is dropped by the play loop.                       *
+ *****************************************************************************/
+static int _seek_track(uint32_t msec)
+{
+    const trackdir_entry_t *track = trackdir_get(&dir, cur_track);
+    uint32_t frame, offset;
+    int status;
+
+    if (!idx_ok)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    frame = seekidx_frame_at(&idx, msec);
+
+    if ((status = seekidx_seek(&idx, frame, &offset, &preroll)) != OK)
+    {
+        return status;
+    }
+
+    _flush_fifo();
+    cur_frame = frame - preroll;
+    resync = 1;
+    pcm_frames = 0;
+
+    readahead_start(&mem, AT25DF641_1, track->offset + offset, track->length - offset);
+    readahead_wait(MAINBUF_SIZE);
+
+    return OK;
+}
+
+#if STREAM_EN
+/*****************************************************************************
+ * @brief Timer tick of the flash and the stream                             *
+ *****************************************************************************/
+static void _tick(void)
+{
+    at25df641_tick();
+    stream_tick();
+}
+
+/*****************************************************************************
+ * @brief Prints the fill level and the counters of the stream               *
+ *****************************************************************************/
+static void _report_stream(void)
+{
+    stream_stats_t stats;
+
+    stream_stats(&stats);
+    printf("Stream: %u bytes, target %u ms, %u underruns, %u overruns, %u dropped\n",
+           stats.received, stats.target_ms, stats.underruns, stats.overruns, stats.dropped);
+}
+
+/*****************************************************************************
+ * @brief Stops the live stream, if it plays                                 *
+ *****************************************************************************/
+static void _stop_stream(void)
+{
+    if (streaming)
+    {
+        _report_stream();
+        stream_stop();
+        streaming = 0;
+    }
+}
+
+/*****************************************************************************
+ * @brief Serves the live stream over the UART                               *
+ *                                                                           *
+ * @detail A new stream stops the playback from the flash and takes over the *
+ *         decoder input. The output starts, when the jitter buffer reached  *
+ *         its target, and stops at the end of the stream.                   *
+ *****************************************************************************/
+static void _stream(void)
+{
+    switch (stream_poll())
+    {
+        case STREAM_EV_START:
+            printf("Stream started\n");
+            readahead_stop();
+            stream_start(&mem);
+            _flush_fifo();
+            _reset_var();
+            streaming = 1;
+            cur_format = TRACKDIR_FMT_MP3;
+            cur_frame = 0;
+            idx_ok = 0;
+            preroll = 0;
+            resync = 0;
+            pcm_frames = 0;
+            pcm_next = 0;
+            break;
+        case STREAM_EV_END:
+            printf("End of stream\n");
+            _report_stream();
+            _report_load();
+            streaming = 0;
+            forever = 0;
+            break;
+        default:
+            break;
+    }
+}
+#endif /* STREAM_EN */
+
+#if INGEST_EN
+/*****************************************************************************
+ * @brief Serves the upload over the UART                                    *
+ *                                                                           *
+ * @detail An upload changes the work memory, so the PCM cache is switched   *
+ *         off til the commit and a running replay stops. The commit stops   *
+ *         the playback, copies the new content to the orig memory and       *
+ *         loads the new directory.                                          *
+ *****************************************************************************/
+static void _ingest(void)
+{
+    switch (ingest_poll())
+    {
+        case INGEST_EV_WRITE:
+            pcmcache_init(PCMCACHE_OFF, FIFO_BUFF_SIZE * sizeof(int16_t));
+            pcm_frames = pcm_next;
+            break;
+        case INGEST_EV_COMMIT:
+#if STREAM_EN
+            _stop_stream();
+#endif
+            forever = 0;
+            readahead_stop();
+            ingest_commit();
+            _load_dir();
+            pcmcache_init(PCMCACHE_MODE, FIFO_BUFF_SIZE * sizeof(int16_t));
+            break;
+        default:
+            break;
+    }
+}
+#endif /* INGEST_EN */
+
+/*****************************************************************************
+ * @brief Returns the number of the pressed button S1 - S8                   *
+ *                                                                           *
+ * @return 1 - 8 for the pressed button, 0 if no button is pressed           *
+ *****************************************************************************/
+static int _pressed_button(void)
+{
+    if (S1) return 1;
+    if (S2) return 2;
+    if (S3) return 3;
+    if (S4) return 4;
+    if (S5) return 5;
+    if (S6) return 6;
+    if (S7) return 7;
+    if (S8) return 8;
+
+    return 0;
+}
+
+/*****************************************************************************
+ * @brief Check buttons and run the operations                               *
+ *                                                                           *
+ * @detail The buttons S1 - S8 start the tracks 1 - 8 of the directory.      *
+ *         Pressing the button of the playing track again skips SKIP_MSEC    *
+ *         ahead, if the track has a seek index.                             *
+ *****************************************************************************/
+static void _check_buttons(void)
+{
+    static int last_button = 0;
+    int button = _pressed_button();
+    uint32_t frame, msec;
+
+    /* only react on a new press */
+    if (button == last_button)
+    {
+        return;
+    }
+
+    last_button = button;
+
+    /* buttons without a track are ignored */
+    if ((button == 0) || (trackdir_get(&dir, button - 1) == NULL))
+    {
+        return;
+    }
+
+    if (forever && idx_ok && ((button - 1) == cur_track))
+    {
+        frame = (pcm_next < pcm_frames) ? (uint32_t)pcm_next : cur_frame;
+        msec = (uint32_t)(((uint64_t)frame * idx.hdr.frame_samples * 1000) / idx.hdr.samplerate);
+        _seek_track(msec + SKIP_MSEC);
+    }
+    else
+    {
+#if STREAM_EN
+        _stop_stream();
+#endif
+        _reset_var();
+
+        if (_open_track(button - 1) != OK)
+        {
+            forever = 0;
+        }
+    }
+}
+
+/*****************************************************************************
+ * @brief Transfer data trough the FSMC.                                     *
+ *                                                                           *
+ * @detail Sends len samples from the background buffer through the FSMC     *
+ *         interface. Depending on the fsmc mode the samples are transferred *
+ *         one by one (waiting for the FPGA RDY signal on NWAIT) or as       *
+ *         bursts. At last amplify the processed data, which overwrites the  *
+ *         old one.                                                          *
+ *****************************************************************************/
+static inline void _fsmc(int len)
+{
+    int i;
+
+    fsmc_transfer_block((int16_t *)bg_buf->data, len);
+
+    for (i = 0; i < len; i++)
+    {
+        bg_buf->data[i] = bg_buf->data[i] * OUTPUT_AMP;
+    }
+}
+
+/*****************************************************************************
+ * @brief Returns the slot behind the given one                              *
+ *****************************************************************************/
+static inline volatile fifo_t *_next_slot(volatile fifo_t *slot)
+{
+    return (slot == &fifo[FIFO_SLOTS - 1]) ? &fifo[0] : (slot + 1);
+}
+
+/*****************************************************************************
+ * @brief Waits til the background buffer has room for the given slots       *
+ *                                                                           *
+ * @detail The decoder writes a frame into neighbouring slots. If they would *
+ *         wrap around the end of the ring, the last slot is handed to the   *
+ *         ISR without samples and the frame starts at the first slot. The   *
+ *         LED PH13 is set while waiting.                                    *
+ *                                                                           *
+ *         The MP3 library returns whole frames only, so a stereo MPEG-1     *
+ *         frame still waits for and fills two slots. Only mono and MPEG-2   *
+ *         frames and the PCM formats get by with one.                       *
+ *****************************************************************************/
+static inline void _wait_slots(int slots)
+{
+    volatile fifo_t *slot;
+    int i;
+
+    SET_PH13();
+
+    if (((bg_buf - fifo) + slots) > FIFO_SLOTS)
+    {
+        while(bg_buf->full);
+        bg_buf->len = 0;
+        bg_buf->full = 1;
+        bg_buf = &fifo[0];
+    }
+
+    for (i = 0, slot = bg_buf; i < slots; i++, slot++)
+    {
+        while(slot->full);
+    }
+
+    CLR_PH13();
+}
+
+/*****************************************************************************
+ * @brief Hands len samples of the background buffer to the ISR              *
+ *                                                                           *
+ * @detail Every started GRANULE_SIZE samples take a slot, the last one may  *
+ *         be shorter. The ISR plays and releases each slot on its own.      *
+ *****************************************************************************/
+static inline void _next_buffer(int len)
+{
+    do
+    {
+        bg_buf->len = MINIMUM(len, GRANULE_SIZE);
+        len -= bg_buf->len;
+        bg_buf->full = 1;
+        bg_buf = _next_slot(bg_buf);
+    } while (len > 0);
+}
+
+/*****************************************************************************
+ * @brief INTERUPT-SERVICE-ROUTINE                                           *
+ *                                                                           *
+ * @detail First check if the isr_buf is not empty, set the LED on PH11,     *
+ *         when the buffer is full or clear it when it is empty.             *
+ *                                                                           *
+ *         Calculate four values, two for each peripheral output             *
+ *         for each of the two channels. Each channel belongs to their       *
+ *         own physically output, one for left and one for the right.        *
+ *                                                                           *
+ *         Writes the calculated value to the corresponding peripherial      *
+ *         output.                                                           *
+ *                                                                           *
+ *         The index increments by two.                                      *
+ *         The counter counts also four times for four calculated outputs    *
+ *                                                                           *
+ *         Next check if the slot has reached his end.                       *
+ *         When true, reset the slots values and change to the next slot.    *
+ *         When false, end the ISR and wait for the next routine             *
+ *                                                                           *
+ *         A flush request of the main loop empties all slots first. Empty   *
+ *         slots in front of a wrapped frame are skipped.                    *
+ *****************************************************************************/
+static void isr (void)
+{
+    uint16_t dac_left;
+    uint16_t dac_right;
+    uint16_t pwm_left;
+    uint16_t pwm_right;
+    int i;
+
+    if (fifo_flush)
+    {
+        for (i = 0; i < FIFO_SLOTS; i++)
+        {
+            fifo[i].index = 0;
+            fifo[i].full = 0;
+        }
+
+        isr_buf = &fifo[0];
+        fifo_flush = 0;
+    }
+
+    if (isr_buf->full && (isr_buf->len == 0))
+    {
+        isr_buf->full = 0;
+        isr_buf = _next_slot(isr_buf);
+    }
+
+    if (!isr_buf->full)
+    {
+        SET_PH11();
+    }
+    else
+    {
+        CLR_PH11();
+
+        dac_left = calc_dac(isr_buf->data[isr_buf->index]);
+        dac_right = calc_dac(isr_buf->data[isr_buf->index + 1]);
+        pwm_left = calc_pwm(isr_buf->data[isr_buf->index]);
+        pwm_right = calc_pwm(isr_buf->data[isr_buf->index + 1]);
+
+        dac_write(DAC_0, LEFT_CHANNEL, dac_left);
+        dac_write(DAC_0, RIGHT_CHANNEL, dac_right);
+        pwm_set(PWM_0, LEFT_CHANNEL, pwm_left);
+        pwm_set(PWM_0, RIGHT_CHANNEL, pwm_right);
+
+        isr_buf->index += 2;
+        counter += 4;
+
+        if (isr_buf->index >= isr_buf->len)
+        {
+            isr_buf->index = 0;
+            isr_buf->full = 0;
+            isr_buf = _next_slot(isr_buf);
+        }
+    } /* else */
+}
+
+/*****************************************************************************
+ * @brief TFT Service routine                                                *
+ *                                                                           *
+ * @detail Sets a flag, which signals that the display should be refreshed   *
+ *****************************************************************************/
+static void tft (void)
+{
+    tft_refresh = 1;
+}
+
+/*****************************************************************************
+ * @brief Main application                                                   *
+ *                                                                           *
+ * @detail TODO                                                              *
+ *****************************************************************************/
+int main(void)
+{
+    HMP3Decoder mp3Decoder = NULL;
+    MP3FrameInfo frame_info;
+    int skip_bytes;
+    int	bytes_left;
+    int	bytes_avail;
+    int	status;
+    int len;
+    int i;
+    uint32_t start;
+    unsigned char *mem_ptr;
+
+    /* Need to initialize the CEP-TI-LAB-BOARD */
+    initCEP_Board();
+    _reset_var();
+
+    /* Initialize all slots */
+    for (i = 0; i < FIFO_SLOTS; i++)
+    {
+        fifo[i].data = &fifo_data[i * GRANULE_SIZE];
+        fifo[i].index = 0;
+        fifo[i].len = 0;
+        fifo[i].full = 0;
+    }
+
+    /* Set both pointer to first slot */
+    bg_buf = &fifo[0];
+    isr_buf = &fifo[0];
+
+    /* Enable all needed GPIO clocks */
+    GPIOA_CLKEN();
+    GPIOC_CLKEN();
+    GPIOF_CLKEN();
+    GPIOH_CLKEN();
+    GPIOI_CLKEN();
+    WORK_CS_PORT_CLKEN();
+    ORIG_CS_PORT_CLKEN();
+
+    /* Initialize all needed peripheral low-level drivers */
+    fsmc_init();                                  /**< FSMC interface */
+    timer_init(TIMER_0, isr);                     /**< PWM Output timer */
+    timer_init(TIMER_1, tft);                     /**< TFT Output timer */
+#if STREAM_EN
+    timer_init(TIMER_2, _tick);                   /**< Flash program/erase and stream tick */
+#else
+    timer_init(TIMER_2, at25df641_tick);          /**< Flash program/erase tick */
+#endif
+    dac_init(DAC_0);                              /**< DAC (PA4) Analog Output */
+    spi_init_master(SPI_0, SPI_BAUD_42MHZ_DIV_2); /**< SPI3 with 21 MHz */
+    at25df641_init(AT25DF641_1);                  /**< init orig memory */
+    at25df641_init(AT25DF641_0);                  /**< init work memory */
+    gpio_init(GPIO_DIR_OUT, GPIOI, PI7);          /**< D23 */
+    gpio_init(GPIO_DIR_OUT, GPIOH, PH11);         /**< Underflow-LED */
+    gpio_init(GPIO_DIR_OUT, GPIOI, PI6);          /**< D22 */
+    gpio_init(GPIO_DIR_OUT, GPIOH, PH13);         /**< Wait-LED */
+
+    bench_init();                                 /**< cycle counter of the cpu load */
+
+#if BENCH_EN
+    bench_fsmc(fsmc_clock());
+    bench_flash_read(AT25DF641_1, SPI_WIRE_FREQ);
+    bench_flash_verify(SPI_WIRE_FREQ);
+    bench_flash_append(AT25DF641_0, BENCH_ADDR);
+    at25df641_sync_range(AT25DF641_0, AT25DF641_1, BENCH_ADDR, AT25DF641_BLOCK_SIZE, NULL);
+
+    /* the block lies in a PCM cache slot, dropping its header refills the slot */
+    at25df641_erase_block(AT25DF641_0, BENCH_ADDR - (BENCH_ADDR % PCMCACHE_SLOT), BLOCK_ERASE_4KB);
+#endif
+
+    /* Fills the memory buffer for the first time */
+    pcmcache_init(PCMCACHE_MODE, FIFO_BUFF_SIZE * sizeof(int16_t));
+    _load_dir();
+
+#if BENCH_EN
+    if ((trackdir_get(&dir, 0) != NULL) && (dir.entry[0].format == TRACKDIR_FMT_MP3))
+    {
+        bench_mp3_decode(AT25DF641_1, dir.entry[0].offset + dir.entry[0].first_frame,
+                         dir.entry[0].length - dir.entry[0].first_frame);
+    }
+#endif
+
+#if INGEST_EN
+    if (ingest_init() != OK) {
+        printf("ingest_init() [ FAIL ]\n");
+    }
+#endif
+#if STREAM_EN
+    if (stream_init() != OK) {
+        printf("stream_init() [ FAIL ]\n");
+    }
+#endif
+
+    if (_open_track(0) != OK)
+    {
+        forever = 0;
+    }
+
+    /* Initialize a new mp3 decoder */
+    if ((mp3Decoder = MP3InitDecoder()) == 0) {
+        perror("MP3InitDecoder() [ FAIL ]\n");
+        return 1;
+    }
+
+    /* Main loop */
+    while (1)
+    {
+        /*********************************************************************
+         * @detail MP3 Play loop.                                            *
+         *         -. Serve the upload over the UART [Optional]              *
+         *         -. Serve the live stream over the UART [Optional], which  *
+         *            replaces the flash in 1. and drops frames in 5.        *
+         *         0. Replay the cached start of the track, if any. PCM and  *
+         *            ADPCM tracks are decoded by pcmdec instead of 1. - 5.  *
+         *         1. Find the next word of the track                        *
+         *         2. Set the LED PH13 and wait til the slots of the frame   *
+         *            are empty                                              *
+         *         3. Clear the LED PH13, because the slots are empty        *
+         *         4. Decodes a new frame                                    *
+         *         5. Clean up the memory, the read-ahead refills it. The    *
+         *            output of preroll frames after a seek is dropped       *
+         *         6. Starts the FSMC module, offers the output to the cache *
+         *         7. Marks the written slots as full                        *
+         *         8. Set the bg_buf pointer behind these slots              *
+         *         9. [Optional] check buttons when playing                  *
+         *********************************************************************/
+        while (forever)
+        {
+#if TFT_EN
+            if (tft_refresh)
+            {
+                _lcd_out();
+                tft_refresh = 0;
+            }
+#endif
+#if INGEST_EN
+            _ingest();
+
+            if (!forever)
+            {
+                break;
+            }
+#endif
+#if STREAM_EN
+            _stream();
+
+            if (!forever)
+            {
+                break;
+            }
+#endif
+            /* buffered small writes go out after AT25DF641_WCB_TIMEOUT */
+            at25df641_wcb_poll();
+            _prof_mark();
+
+            /* the cached start needs no decoding */
+            if (pcm_next < pcm_frames)
+            {
+                _wait_slots(MAX_NGRAN);
+                _prof(PROF_WAIT);
+
+                if (pcmcache_read(pcm_next++, (int16_t *)bg_buf->data) != OK)
+                {
+                    printf("pcmcache_read() [ FAIL ]\n");
+                    forever = 0;
+                    break;
+                }
+
+                _prof(PROF_DECODE);
+                readahead_poll();
+                _prof(PROF_FLASH);
+                _next_buffer(FIFO_BUFF_SIZE);
+                _prof(PROF_OUTPUT);
+                _prof_frame();
+                _check_buttons();
+                continue;
+            }
+
+            if (cur_format != TRACKDIR_FMT_MP3)
+            {
+                readahead_wait(pcm_need);
+                _prof(PROF_INPUT);
+                _wait_slots(1);
+                _prof(PROF_WAIT);
+
+                start = bench_cycles();
+                len = pcmdec_decode(&pcm, &mem, (int16_t *)bg_buf->data, GRANULE_SIZE);
+                load_cycles[cur_format] += bench_cycles() - start;
+                _prof(PROF_DECODE);
+                load_samples[cur_format] += len / 2;
+
+                if (len == 0)
+                {
+                    printf("End of track\n");
+                    _report_load();
+                    forever = 0;
+                    break;
+                }
+
+                /* the last slot of the track is shorter */
+                readahead_poll();
+                _prof(PROF_FLASH);
+                _fsmc(len);
+                _next_buffer(len);
+                _prof(PROF_OUTPUT);
+                _prof_frame();
+                _check_buttons();
+                continue;
+            }
+
+#if STREAM_EN
+            if (streaming)
+            {
+                /* an underrun refills the jitter buffer, the output runs dry meanwhile */
+                if (!stream_ready(MAINBUF_SIZE))
+                {
+                    _check_buttons();
+                    continue;
+                }
+            }
+            else
+#endif
+            if (readahead_wait(MAINBUF_SIZE) == 0)
+            {
+                printf("End of track\n");
+                _report_load();
+                forever = 0;
+                break;
+            }
+
+            mem_ptr = inbuf_read_ptr(&mem, &bytes_left);
+
+            if ((skip_bytes = MP3FindSyncWord(mem_ptr, bytes_left)) > 0)
+            {
+                printf("Bytes skipped: %d\n", skip_bytes);
+                inbuf_consume(&mem, skip_bytes);
+#if STREAM_EN
+                /* the rest of the frame may still be on the line */
+                if (streaming)
+                {
+                    continue;
+                }
+#endif
+                readahead_wait(MAINBUF_SIZE);
+                mem_ptr = inbuf_read_ptr(&mem, &bytes_left);
+            }
+#if STREAM_EN
+            else if ((skip_bytes < 0) && streaming)
+            {
+                /* no frame in the buffer, wait for more of the stream */
+                inbuf_consume(&mem, bytes_left);
+                continue;
+            }
+#endif
+            else if (skip_bytes < 0)
+            {
+                printf("MP3FindSyncWord() [ FAIL ]\n");
+                forever = 0;
+                break;
+            }
+
+            _prof(PROF_INPUT);
+
+            /* a mono or MPEG-2 frame fits into one slot, a stereo MPEG-1 frame needs two */
+            if ((MP3GetNextFrameInfo(mp3Decoder, &frame_info, mem_ptr) == ERR_MP3_NONE) &&
+                (frame_info.outputSamps <= GRANULE_SIZE))
+            {
+                _wait_slots(1);
+            }
+            else
+            {
+                _wait_slots(MAX_NGRAN);
+            }
+
+            _prof(PROF_WAIT);
+            bytes_avail = bytes_left;
+            start = bench_cycles();
+
+            /* preroll frames may miss their bit reservoir */
+            status = MP3Decode(mp3Decoder, &mem_ptr, &bytes_left, (short *)bg_buf->data, 0);
+            _prof(PROF_DECODE);
+
+#if STREAM_EN
+            /* gaps of the stream break frames, the decoder searches the next one */
+            if ((status < 0) && streaming)
+            {
+                inbuf_consume(&mem, ((bytes_avail - bytes_left) > 0) ? (bytes_avail - bytes_left) : 1);
+                continue;
+            }
+#endif
+
+            /* the first frame behind a seek may still miss its reservoir */
+            if ((status < 0) && (preroll == 0) &&
+                !(resync && (status == ERR_MP3_MAINDATA_UNDERFLOW)))
+            {
+                printf("MP3Decode() [ ERROR %d ]\n", status);
+                forever = 0;
+                break;
+            }
+
+            load_cycles[TRACKDIR_FMT_MP3] += bench_cycles() - start;
+            inbuf_consume(&mem, bytes_avail - bytes_left);
+            MP3GetLastFrameInfo(mp3Decoder, &frame_info);
+
+            if (frame_info.nChans > 0)
+            {
+                load_samples[TRACKDIR_FMT_MP3] += frame_info.outputSamps / frame_info.nChans;
+            }
+
+            readahead_set_bitrate(frame_info.bitrate);
+            readahead_poll();
+            _prof(PROF_FLASH);
+            cur_frame++;
+
+            if (preroll > 0)
+            {
+                preroll--;
+                continue;
+            }
+
+            /* a frame without its reservoir is dropped like a preroll frame */
+            if (status < 0)
+            {
+                continue;
+            }
+
+            resync = 0;
+
+#if STREAM_EN
+            if (streaming)
+            {
+                stream_set_bitrate(frame_info.bitrate);
+
+                /* frames above the target are dropped to lower the latency */
+                if (stream_skip())
+                {
+                    continue;
+                }
+
+                _fsmc(frame_info.outputSamps);
+                _next_buffer(frame_info.outputSamps);
+                _prof(PROF_OUTPUT);
+                _prof_frame();
+                _check_buttons();
+                continue;
+            }
+#endif
+
+            _fsmc(frame_info.outputSamps);
+            _prof(PROF_OUTPUT);
+
+            /* the cache replays full frames only, the start stops before a short one */
+            if (frame_info.outputSamps == FIFO_BUFF_SIZE)
+            {
+                pcmcache_offer(cur_frame - 1, (const int16_t *)bg_buf->data);
+            }
+
+            _prof(PROF_FLASH);
+            _next_buffer(frame_info.outputSamps);
+            _prof(PROF_OUTPUT);
+            _prof_frame();
+            _check_buttons();
+        }  /* while (forever) */
+
+#if INGEST_EN
+        _ingest();
+#endif
+#if STREAM_EN
+        _stream();
+#endif
+        at25df641_wcb_poll();
+        _check_buttons();
+    }  /* while (1) */
+
+    return 0; // Never reached.
+}
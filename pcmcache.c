@@ -0,0 +1,256 @@
+/**
+ * @{
+ *
+ * @brief     Cache of the decoded track starts on the work chip
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "include/pcmcache.h"
+#include "include/trackdir.h"
+#include "driver/at25df641.h"
+#include "driver/define/at25df641_def.h"
+
+/** Device of the slots */
+#define PCM_DEV         (AT25DF641_0)
+/** Largest output frame, MAX_NCHAN * MAX_NGRAN * MAX_NSAMP of mp3dec.h */
+#define FRAME_MAX       (2 * 2 * 576 * sizeof(int16_t))
+/** Frames start behind the header page */
+#define FRAME_BASE      (AT25DF641_PAGE_SIZE)
+
+/** Transactions of a slot, the erases are queued before the header */
+#define T_ERASE         (0)
+#define T_HEADER        (PCMCACHE_SLOT / AT25DF641_BLOCK_SIZE)
+#define T_FRAME         (T_HEADER + 1)
+#define T_FLAG          (T_HEADER + 2)
+#define T_NUMOF         (T_HEADER + 3)
+
+/**
+ * @brief State of the opened slot
+ */
+static struct {
+    int mode;                           /**< PCMCACHE_x */
+    uint32_t frame_bytes;               /**< bytes of one output frame */
+    int open;                           /**< flag if a slot is opened */
+    int fill;                           /**< flag if the slot may be filled */
+    uint32_t addr;                      /**< flash address of the slot */
+    pcmcache_hdr_t hdr;                 /**< header, filled flags as in flash */
+    int ready;                          /**< flag if the header is in flash */
+    uint32_t frame;                     /**< frame of the capture buffer */
+    at25df641_trans_t trans[T_NUMOF];   /**< queued transactions */
+    volatile uint8_t pending[T_NUMOF];  /**< flags of running transactions */
+    volatile int8_t result[T_NUMOF];    /**< results of the transactions */
+    int16_t buf[FRAME_MAX / sizeof(int16_t)]; /**< capture buffer */
+} pc;
+
+/** Programmed as filled flag */
+static const unsigned char flag_set = 0x00;
+
+/**
+ * @brief Callback of all transactions, from interrupt context
+ */
+static void _done(void *arg, int status)
+{
+    int n = (int)(intptr_t)arg;
+
+    pc.result[n] = (status == OK) ? OK : ERROR_WRITE;
+    pc.pending[n] = 0;
+}
+
+/**
+ * @brief Checks if a transaction of the slot is queued or running
+ */
+static int _busy(void)
+{
+    int i;
+
+    for (i = 0; i < T_NUMOF; i++)
+    {
+        if (pc.pending[i])
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Queues a program or erase of the slot in the background
+ */
+static int _submit(int n, at25df641_trans_type_t type, const void *data, uint32_t size, uint32_t addr)
+{
+    at25df641_trans_t *trans = &pc.trans[n];
+    int status;
+
+    memset(trans, 0, sizeof *trans);
+    trans->type = type;
+    trans->prio = PRIO_BACKGROUND;
+    trans->dev = PCM_DEV;
+    trans->erase_cmd = BLOCK_ERASE_64KB;
+    trans->data = (unsigned char *)data;
+    trans->addr = addr;
+    trans->size = size;
+    trans->cb = _done;
+    trans->arg = (void *)(intptr_t)n;
+
+    pc.pending[n] = 1;
+
+    if ((status = at25df641_submit(trans)) != OK)
+    {
+        pc.pending[n] = 0;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Returns the number of stored frames from the start of the slot
+ */
+static int _cached_frames(void)
+{
+    int n = 0;
+
+    while ((n < pc.hdr.frames) && (pc.hdr.filled[n] == 0x00))
+    {
+        n++;
+    }
+
+    return n;
+}
+
+void pcmcache_init(int mode, uint32_t frame_bytes)
+{
+    pc.mode = (frame_bytes <= FRAME_MAX) ? mode : PCMCACHE_OFF;
+    pc.frame_bytes = frame_bytes;
+    pc.open = 0;
+}
+
+int pcmcache_open(int n, const trackdir_entry_t *track)
+{
+    uint32_t frames = (PCMCACHE_SLOT - FRAME_BASE) / pc.frame_bytes;
+    int i;
+
+    pc.open = 0;
+    pc.fill = 0;
+
+    /* only decoding MP3 costs more than the replay */
+    if ((pc.mode == PCMCACHE_OFF) || (n >= (AT25DF641_MEM_SIZE / PCMCACHE_SLOT)) ||
+        (track->format != TRACKDIR_FMT_MP3) ||
+        ((pc.mode == PCMCACHE_SELECTED) && !(track->flags & TRACKDIR_FLAG_PCMCACHE)))
+    {
+        return 0;
+    }
+
+    /* the transactions of the last slot still use the header */
+    if (_busy())
+    {
+        return 0;
+    }
+
+    pc.addr = n * PCMCACHE_SLOT;
+
+    if (at25df641_read(PCM_DEV, (unsigned char *)&pc.hdr, sizeof pc.hdr, pc.addr) != OK)
+    {
+        return 0;
+    }
+
+    pc.open = 1;
+    pc.fill = 1;
+    pc.frame = PCMCACHE_MAX_FRAMES;
+
+    if ((pc.hdr.magic == PCMCACHE_MAGIC) && (pc.hdr.offset == track->offset) &&
+        (pc.hdr.length == track->length) && (pc.hdr.frame_bytes == pc.frame_bytes) &&
+        (pc.hdr.frames <= PCMCACHE_MAX_FRAMES))
+    {
+        pc.ready = 1;
+        return _cached_frames();
+    }
+
+    /* a slot of another track or image, start it again */
+    pc.ready = 0;
+    pc.hdr.magic = PCMCACHE_MAGIC;
+    pc.hdr.offset = track->offset;
+    pc.hdr.length = track->length;
+    pc.hdr.frame_bytes = (uint16_t)pc.frame_bytes;
+    pc.hdr.frames = (uint16_t)((frames < PCMCACHE_MAX_FRAMES) ? frames : PCMCACHE_MAX_FRAMES);
+    memset(pc.hdr.filled, 0xFF, sizeof pc.hdr.filled);
+
+    /* the queue keeps the order, the header follows the erases */
+    for (i = T_ERASE; i < T_HEADER; i++)
+    {
+        _submit(i, TRANS_ERASE, NULL, 0, pc.addr + i * AT25DF641_BLOCK_SIZE);
+    }
+
+    _submit(T_HEADER, TRANS_WRITE, &pc.hdr, offsetof(pcmcache_hdr_t, filled), pc.addr);
+
+    return 0;
+}
+
+int pcmcache_read(uint32_t frame, int16_t *pcm)
+{
+    if (!pc.open || (frame >= pc.hdr.frames) || (pc.hdr.filled[frame] != 0x00))
+    {
+        return ERROR_DEFAULT;
+    }
+
+    return at25df641_read(PCM_DEV, (unsigned char *)pcm, pc.frame_bytes,
+                          pc.addr + FRAME_BASE + frame * pc.frame_bytes);
+}
+
+void pcmcache_offer(uint32_t frame, const int16_t *pcm)
+{
+    int i;
+
+    if (!pc.open || !pc.fill || _busy())
+    {
+        return;
+    }
+
+    if (!pc.ready)
+    {
+        /* the header was written after the erases */
+        for (i = T_ERASE; i <= T_HEADER; i++)
+        {
+            if (pc.result[i] != OK)
+            {
+                pc.fill = 0;
+                return;
+            }
+        }
+
+        pc.ready = 1;
+    }
+
+    /* the frame is stored, mark it as filled */
+    if (pc.frame < PCMCACHE_MAX_FRAMES)
+    {
+        if (pc.result[T_FRAME] != OK)
+        {
+            pc.fill = 0;
+            return;
+        }
+
+        _submit(T_FLAG, TRANS_WRITE, &flag_set, 1,
+                pc.addr + offsetof(pcmcache_hdr_t, filled) + pc.frame);
+        pc.hdr.filled[pc.frame] = 0x00;
+        pc.frame = PCMCACHE_MAX_FRAMES;
+        return;
+    }
+
+    if ((frame >= pc.hdr.frames) || (pc.hdr.filled[frame] == 0x00))
+    {
+        return;
+    }
+
+    memcpy(pc.buf, pcm, pc.frame_bytes);
+    pc.frame = frame;
+    _submit(T_FRAME, TRANS_WRITE, pc.buf, pc.frame_bytes,
+            pc.addr + FRAME_BASE + frame * pc.frame_bytes);
+}
@@ -0,0 +1,338 @@
+/**
+ * @{
+ *
+ * @brief     Decoder of the PCM and IMA-ADPCM tracks
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "include/pcmdec.h"
+#include "include/readahead.h"
+#include "driver/at25df641.h"
+#include "driver/define/at25df641_def.h"
+
+/** Largest WAV header in front of the samples */
+#define WAV_HEADER_MAX  (256)
+/** Format tags of the fmt chunk */
+#define WAV_TAG_PCM     (0x0001)
+#define WAV_TAG_ADPCM   (0x0011)
+
+/** Reads little endian values of the WAV header */
+#define LE16(p)         ((uint16_t)((p)[0] | ((p)[1] << 8)))
+#define LE32(p)         ((uint32_t)LE16(p) | ((uint32_t)LE16((p) + 2) << 16))
+
+/** Quantizer step sizes of IMA-ADPCM */
+static const int16_t step_tab[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+    45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190,
+    209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724,
+    796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272,
+    2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132,
+    7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500,
+    20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/** Step index change by the magnitude of a code */
+static const int8_t index_tab[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/**
+ * @brief Predictor of one channel
+ */
+typedef struct {
+    int pred;       /**< last sample */
+    int index;      /**< index into step_tab */
+} adpcm_state_t;
+
+/**
+ * @brief Decodes one 4 bit code, shifts and adds only
+ */
+static inline int16_t _adpcm_code(adpcm_state_t *st, int code)
+{
+    int step = step_tab[st->index];
+    int diff = step >> 3;
+
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+
+    st->pred += (code & 8) ? -diff : diff;
+
+    if (st->pred > 32767)
+    {
+        st->pred = 32767;
+    }
+    else if (st->pred < -32768)
+    {
+        st->pred = -32768;
+    }
+
+    st->index += index_tab[code & 7];
+
+    if (st->index < 0)
+    {
+        st->index = 0;
+    }
+    else if (st->index > 88)
+    {
+        st->index = 88;
+    }
+
+    return (int16_t)st->pred;
+}
+
+/**
+ * @brief Decodes an ADPCM block into the stage
+ *
+ * Every channel starts with a header of the first sample and the step
+ * index, followed by words of 8 codes per channel in turn. A truncated
+ * block at the end of a track is decoded as far as it goes.
+ */
+static void _adpcm_block(pcmdec_t *dec, const unsigned char *p, int len)
+{
+    adpcm_state_t st[2];
+    int ch = dec->channels;
+    int words = (len - 4 * ch) / (4 * ch);
+    int16_t *out;
+    int c, w, i;
+
+    for (c = 0; c < ch; c++)
+    {
+        st[c].pred = (int16_t)LE16(p);
+        st[c].index = (p[2] > 88) ? 88 : p[2];
+        dec->stage[c] = (int16_t)st[c].pred;
+        p += 4;
+    }
+
+    for (w = 0; w < words; w++)
+    {
+        for (c = 0; c < ch; c++)
+        {
+            out = &dec->stage[(1 + w * 8) * ch + c];
+
+            /* low nibble first */
+            for (i = 0; i < 4; i++, p++)
+            {
+                out[0] = _adpcm_code(&st[c], *p & 0x0F);
+                out[ch] = _adpcm_code(&st[c], *p >> 4);
+                out += 2 * ch;
+            }
+        }
+    }
+
+    dec->stage_len = (1 + words * 8) * ch;
+    dec->stage_pos = 0;
+}
+
+/**
+ * @brief Copies 16 bit samples from the input buffer
+ */
+static int _pcm_copy(pcmdec_t *dec, inbuf_t *in, int16_t *out, int len)
+{
+    int frame = 2 * dec->channels;
+    int bytes = (len / 2) * frame;
+    int avail, i;
+    unsigned char *p;
+
+    /* the guard keeps this much contiguous */
+    if (bytes > INBUF_GUARD)
+    {
+        bytes = INBUF_GUARD;
+    }
+
+    readahead_wait(bytes);
+    p = inbuf_read_ptr(in, &avail);
+
+    if (avail < bytes)
+    {
+        bytes = avail;
+    }
+
+    bytes -= bytes % frame;
+
+    if (dec->channels == 2)
+    {
+        memcpy(out, p, bytes);
+    }
+    else
+    {
+        for (i = 0; i < bytes; i += 2)
+        {
+            out[i] = out[i + 1] = (int16_t)LE16(&p[i]);
+        }
+    }
+
+    inbuf_consume(in, bytes);
+
+    return (bytes / frame) * 2;
+}
+
+/**
+ * @brief Hands out decoded ADPCM samples, decodes the next block if needed
+ */
+static int _adpcm_copy(pcmdec_t *dec, inbuf_t *in, int16_t *out, int len)
+{
+    const unsigned char *p;
+    int avail, n, i;
+
+    if (dec->stage_pos >= dec->stage_len)
+    {
+        readahead_wait(dec->block_align);
+        p = inbuf_read_ptr(in, &avail);
+
+        if (inbuf_fill(in) < (4 * dec->channels))
+        {
+            return 0;
+        }
+
+        n = (inbuf_fill(in) < dec->block_align) ? inbuf_fill(in) : dec->block_align;
+
+        /* a block across the end of the ring is put together first */
+        if (avail < n)
+        {
+            memcpy(dec->block, p, avail);
+            inbuf_consume(in, avail);
+            p = inbuf_read_ptr(in, &i);
+            memcpy(&dec->block[avail], p, n - avail);
+            inbuf_consume(in, n - avail);
+            _adpcm_block(dec, dec->block, n);
+        }
+        else
+        {
+            /* consumed space may be refilled at once, so decode first */
+            _adpcm_block(dec, p, n);
+            inbuf_consume(in, n);
+        }
+    }
+
+    n = dec->stage_len - dec->stage_pos;
+
+    if (dec->channels == 2)
+    {
+        n = (n < len) ? n : len;
+        memcpy(out, &dec->stage[dec->stage_pos], n * sizeof(int16_t));
+        dec->stage_pos += n;
+
+        return n;
+    }
+
+    n = (n < (len / 2)) ? n : (len / 2);
+
+    for (i = 0; i < n; i++)
+    {
+        out[2 * i] = out[2 * i + 1] = dec->stage[dec->stage_pos + i];
+    }
+
+    dec->stage_pos += n;
+
+    return 2 * n;
+}
+
+int pcmdec_open(pcmdec_t *dec, at25df641_dev_t dev, const trackdir_entry_t *track)
+{
+    unsigned char hdr[WAV_HEADER_MAX];
+    uint32_t pos, size, len;
+    uint16_t tag, channels, block_align, bits;
+    int status;
+
+    memset(dec, 0, sizeof(pcmdec_t));
+    len = track->first_frame;
+
+    if ((len < 12) || (len > WAV_HEADER_MAX))
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    if ((status = at25df641_read(dev, hdr, len, track->offset)) != OK)
+    {
+        return status;
+    }
+
+    if ((memcmp(hdr, "RIFF", 4) != 0) || (memcmp(&hdr[8], "WAVE", 4) != 0))
+    {
+        return ERROR_ID;
+    }
+
+    /* find the fmt chunk, chunks are padded to an even size */
+    for (pos = 12; (pos + 8) <= len; pos += 8 + ((size + 1) & ~1u))
+    {
+        size = LE32(&hdr[pos + 4]);
+
+        if (size > len)
+        {
+            return ERROR_ID;
+        }
+
+        if ((memcmp(&hdr[pos], "fmt ", 4) == 0) && (size >= 16) && ((pos + 8 + 16) <= len))
+        {
+            break;
+        }
+    }
+
+    if ((pos + 8) > len)
+    {
+        return ERROR_ID;
+    }
+
+    tag = LE16(&hdr[pos + 8]);
+    channels = LE16(&hdr[pos + 10]);
+    block_align = LE16(&hdr[pos + 20]);
+    bits = LE16(&hdr[pos + 22]);
+
+    if ((channels < 1) || (channels > 2))
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    if ((track->format == TRACKDIR_FMT_PCM16) && (tag == WAV_TAG_PCM) && (bits == 16))
+    {
+        dec->format = TRACKDIR_FMT_PCM16;
+    }
+    else if ((track->format == TRACKDIR_FMT_ADPCM) && (tag == WAV_TAG_ADPCM) && (bits == 4) &&
+             (block_align > (4 * channels)) && (block_align <= TRACKDIR_ADPCM_BLOCK_MAX) &&
+             ((block_align % (4 * channels)) == 0))
+    {
+        dec->format = TRACKDIR_FMT_ADPCM;
+        dec->block_align = block_align;
+    }
+    else
+    {
+        return ERROR_ID;
+    }
+
+    dec->channels = (uint8_t)channels;
+    dec->bitrate = (int)(LE32(&hdr[pos + 16]) * 8);
+
+    return OK;
+}
+
+int pcmdec_decode(pcmdec_t *dec, inbuf_t *in, int16_t *out, int len)
+{
+    int pos = 0;
+    int n;
+
+    while (pos < len)
+    {
+        if (dec->format == TRACKDIR_FMT_PCM16)
+        {
+            n = _pcm_copy(dec, in, &out[pos], len - pos);
+        }
+        else
+        {
+            n = _adpcm_copy(dec, in, &out[pos], len - pos);
+        }
+
+        if (n == 0)
+        {
+            break;
+        }
+
+        pos += n;
+    }
+
+    return pos;
+}
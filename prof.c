@@ -0,0 +1,100 @@
+/**
+ * @{
+ *
+ * @brief     Cycles of the play loop stages per frame
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "include/prof.h"
+
+/**
+ * @brief Measurements of all stages
+ */
+static struct {
+    uint32_t cur[PROF_STAGES];  /**< time of the stages in the current frame */
+    uint32_t min[PROF_STAGES];  /**< least time per frame */
+    uint32_t max[PROF_STAGES];  /**< largest time per frame */
+    uint64_t sum[PROF_STAGES];  /**< time of all closed frames */
+    uint32_t frames;            /**< number of closed frames */
+} prof;
+
+void prof_reset(void)
+{
+    memset(&prof, 0, sizeof prof);
+}
+
+void prof_add(int stage, uint32_t time)
+{
+    if ((stage >= 0) && (stage < PROF_STAGES))
+    {
+        prof.cur[stage] += time;
+    }
+}
+
+void prof_frame(void)
+{
+    int i;
+
+    for (i = 0; i < PROF_STAGES; i++)
+    {
+        if ((prof.frames == 0) || (prof.cur[i] < prof.min[i]))
+        {
+            prof.min[i] = prof.cur[i];
+        }
+
+        if (prof.cur[i] > prof.max[i])
+        {
+            prof.max[i] = prof.cur[i];
+        }
+
+        prof.sum[i] += prof.cur[i];
+        prof.cur[i] = 0;
+    }
+
+    prof.frames++;
+}
+
+void prof_get(int stage, prof_stats_t *stats)
+{
+    memset(stats, 0, sizeof *stats);
+
+    if ((stage < 0) || (stage >= PROF_STAGES) || (prof.frames == 0))
+    {
+        return;
+    }
+
+    stats->frames = prof.frames;
+    stats->min = prof.min[stage];
+    stats->avg = (uint32_t)(prof.sum[stage] / prof.frames);
+    stats->max = prof.max[stage];
+}
+
+void prof_report(uint32_t freq)
+{
+    static const char *stage_name[PROF_STAGES] = {"input", "wait", "decode", "output", "flash"};
+    prof_stats_t stats;
+    int i;
+
+    if ((prof.frames == 0) || (freq == 0))
+    {
+        return;
+    }
+
+    printf("Stages of %u frames in us (min / avg / max):\n", prof.frames);
+
+    for (i = 0; i < PROF_STAGES; i++)
+    {
+        prof_get(i, &stats);
+        printf("  %-6s %6u / %6u / %6u\n", stage_name[i],
+               (uint32_t)(((uint64_t)stats.min * 1000000) / freq),
+               (uint32_t)(((uint64_t)stats.avg * 1000000) / freq),
+               (uint32_t)(((uint64_t)stats.max * 1000000) / freq));
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * @{
+ *
+ * @brief     Background read-ahead of compressed data into the input buffer
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "include/readahead.h"
+#include "include/inbuf.h"
+#include "driver/at25df641.h"
+#include "driver/define/at25df641_def.h"
+
+/** Type for read-ahead state */
+typedef struct {
+    inbuf_t *buf;              /**< buffer which is filled */
+    at25df641_trans_t trans;   /**< playback read of the driver */
+    uint32_t addr;             /**< address of the next transfer */
+    uint32_t remaining;        /**< bytes of the stream not yet requested */
+    int depth;                 /**< number of bytes to keep prefetched */
+    volatile int pending;      /**< bytes of the running transfer */
+    volatile uint8_t running;  /**< flag if prefetching is enabled */
+    uint8_t primed;            /**< flag if the first block was waited for */
+    uint32_t underruns;        /**< number of waits of the decoder */
+} readahead_t;
+
+/** Read-ahead state memory */
+static readahead_t ra;
+
+static void _next(void);
+
+/**
+ * @brief Commits the received bytes and starts the next transfer
+ */
+static void _done(void *arg, int status)
+{
+    if (status == OK)
+    {
+        inbuf_commit(ra.buf, ra.pending);
+    }
+    else
+    {
+        ra.running = 0;
+    }
+
+    ra.pending = 0;
+    _next();
+}
+
+/**
+ * @brief Starts a transfer if the prefetch depth is not reached
+ */
+static void _next(void)
+{
+    unsigned char *ptr;
+    int len, missing, status;
+
+    if (!ra.running || ra.pending)
+    {
+        return;
+    }
+
+    missing = ra.depth - inbuf_fill(ra.buf);
+    ptr = inbuf_write_ptr(ra.buf, &len);
+    len = MINIMUM(len, MINIMUM(missing, READAHEAD_CHUNK));
+    len = (int)MINIMUM((uint32_t)len, ra.remaining);
+
+    if (ra.remaining == 0)
+    {
+        ra.running = 0;
+        return;
+    }
+
+    if (len <= 0)
+    {
+        return;
+    }
+
+    ra.pending = len;
+    ra.trans.data = ptr;
+    ra.trans.addr = ra.addr;
+    ra.trans.size = len;
+
+    if ((status = at25df641_submit(&ra.trans)) == OK)
+    {
+        ra.addr += len;
+        ra.remaining -= len;
+    }
+    else
+    {
+        /* the last read is not handed back yet, readahead_poll() tries again */
+        if (status != ERROR_BUSY)
+        {
+            ra.running = 0;
+        }
+
+        ra.pending = 0;
+    }
+}
+
+void readahead_start(inbuf_t *buf, at25df641_dev_t dev, uint32_t addr, uint32_t len)
+{
+    readahead_stop();
+
+    inbuf_reset(buf);
+    ra.buf = buf;
+    ra.trans.type = TRANS_READ;
+    ra.trans.prio = PRIO_PLAYBACK;
+    ra.trans.dev = dev;
+    ra.trans.cb = _done;
+    ra.trans.arg = NULL;
+    ra.addr = addr;
+    ra.remaining = len;
+    ra.depth = INBUF_SIZE;
+    ra.underruns = 0;
+    ra.primed = 0;
+    ra.running = 1;
+
+    _next();
+}
+
+void readahead_stop(void)
+{
+    ra.running = 0;
+    while (ra.pending);
+}
+
+void readahead_poll(void)
+{
+    _next();
+}
+
+void readahead_set_bitrate(int bitrate)
+{
+    int depth = (int)(((int64_t)bitrate * READAHEAD_MS) / (8 * 1000));
+
+    if (depth < READAHEAD_MIN)
+    {
+        depth = READAHEAD_MIN;
+    }
+    else if (depth > INBUF_SIZE)
+    {
+        depth = INBUF_SIZE;
+    }
+
+    ra.depth = depth;
+}
+
+int readahead_wait(int bytes)
+{
+    if ((inbuf_fill(ra.buf) < bytes) && ra.running)
+    {
+        if (ra.primed)
+        {
+            ra.underruns++;
+        }
+
+        while ((inbuf_fill(ra.buf) < bytes) && (ra.running || ra.pending))
+        {
+            _next();
+        }
+    }
+
+    ra.primed = 1;
+
+    return inbuf_fill(ra.buf);
+}
+
+uint32_t readahead_underruns(void)
+{
+    return ra.underruns;
+}
@@ -0,0 +1,161 @@
+/**
+ * @{
+ *
+ * @brief     Frame seek index of a track
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+
+#include "include/seekidx.h"
+#include "include/trackdir.h"
+#include "driver/at25df641.h"
+#include "driver/define/at25df641_def.h"
+
+/** Bytes of the frame header and the CRC, which are no main data */
+#define FRAME_HEADER        (4 + 2)
+/** Bytes of the stereo side info, the mono one is shorter */
+#define SIDE_INFO_MPEG1     (32)
+#define SIDE_INFO_MPEG2     (17)
+
+/**
+ * @brief Reads the group with the given number
+ */
+static int _read_group(const seekidx_t *idx, uint32_t n, seekidx_group_t *group)
+{
+    return at25df641_read(idx->dev, (unsigned char *)group, sizeof(seekidx_group_t),
+                          idx->addr + n * sizeof(seekidx_group_t));
+}
+
+/**
+ * @brief Returns the least number of main data bytes of a frame
+ *
+ * The reservoir (main_data_begin) counts main data only, so the header and
+ * the largest side info of the layer are not part of it.
+ */
+static uint32_t _main_data(const seekidx_t *idx, uint32_t size)
+{
+    uint32_t overhead = FRAME_HEADER +
+                        ((idx->hdr.frame_samples > 576) ? SIDE_INFO_MPEG1 : SIDE_INFO_MPEG2);
+
+    return (size > overhead) ? (size - overhead) : 0;
+}
+
+/**
+ * @brief Returns the offset of a frame of a group
+ */
+static uint32_t _frame_offset(const seekidx_group_t *group, int pos)
+{
+    uint32_t offset = group->base;
+    int i;
+
+    for (i = 0; i < pos; i++)
+    {
+        offset += group->delta[i];
+    }
+
+    return offset;
+}
+
+int seekidx_open(seekidx_t *idx, at25df641_dev_t dev, const trackdir_entry_t *track)
+{
+    int status;
+
+    if (track->index == 0)
+    {
+        return ERROR_DEFAULT;
+    }
+
+    idx->dev = dev;
+    idx->addr = track->index + sizeof(seekidx_hdr_t);
+
+    if ((status = at25df641_read(dev, (unsigned char *)&idx->hdr, sizeof(seekidx_hdr_t), track->index)) != OK)
+    {
+        return status;
+    }
+
+    if ((idx->hdr.magic != SEEKIDX_MAGIC) || (idx->hdr.frames == 0) ||
+        (idx->hdr.frame_samples == 0) || (idx->hdr.samplerate == 0))
+    {
+        return ERROR_ID;
+    }
+
+    return OK;
+}
+
+uint32_t seekidx_frame_at(const seekidx_t *idx, uint32_t msec)
+{
+    uint64_t frame = ((uint64_t)msec * idx->hdr.samplerate) / (1000 * (uint64_t)idx->hdr.frame_samples);
+
+    if (frame >= idx->hdr.frames)
+    {
+        frame = idx->hdr.frames - 1;
+    }
+
+    return (uint32_t)frame;
+}
+
+int seekidx_seek(const seekidx_t *idx, uint32_t frame, uint32_t *offset, int *preroll)
+{
+    seekidx_group_t group;
+    uint32_t n = frame / SEEKIDX_GROUP;
+    int pos = frame % SEEKIDX_GROUP;
+    uint32_t next_base = 0;
+    uint32_t back = 0;
+    uint32_t reservoir = 0;
+    uint32_t size;
+    int status;
+
+    if (frame >= idx->hdr.frames)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    if ((status = _read_group(idx, n, &group)) != OK)
+    {
+        return status;
+    }
+
+    *offset = _frame_offset(&group, pos);
+
+    /* step back frame by frame til the main data of the frames covers the reservoir */
+    *preroll = 0;
+    while ((reservoir < SEEKIDX_RESERVOIR) && (frame > 0))
+    {
+        if (pos == 0)
+        {
+            next_base = group.base;
+
+            if ((status = _read_group(idx, --n, &group)) != OK)
+            {
+                return status;
+            }
+
+            pos = SEEKIDX_GROUP;
+        }
+
+        pos--;
+        frame--;
+
+        /* the size of the last frame of a group follows from the next base */
+        if (pos < (SEEKIDX_GROUP - 1))
+        {
+            size = group.delta[pos];
+        }
+        else
+        {
+            size = next_base - _frame_offset(&group, pos);
+        }
+
+        back += size;
+        reservoir += _main_data(idx, size);
+        (*preroll)++;
+    }
+
+    *offset -= back;
+
+    return OK;
+}
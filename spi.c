@@ -1,180 +1,431 @@
-/**
- * @{
- *
- * @brief     Low-level peripheral driver for DAC.
- * @author    Copyright (C) Rene Herthel <rene-herthel@outlook.de>
- * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
- *
- * @}
- */
-
-#include <stdio.h>
-#include <stdint.h>
-
-#include "driver/spi.h"
-#include "driver/gpio.h"
-
-#include "driver/debug.h"
-
-/** Shifts to bit 3 baud bit in CR1 register */
-#define SPI_CR1_BR_SHIFT     (3)
-
-int spi_init_master(spi_t dev, spi_baud_t baud)
-{
-    SPI_TypeDef *spi;
-
-    switch (dev)
-    {
-#if SPI_0_EN
-        case SPI_0:
-            spi = SPI_0_DEV;
-            SPI_0_CLKEN();
-            SPI_0_SCK_PORT_CLKEN();
-            SPI_0_MISO_PORT_CLKEN();
-            SPI_0_MOSI_PORT_CLKEN();
-            break;
-#endif /* SPI_0_EN */
-        default:
-            return -1;
-    }
-
-    if (spi_conf_pins(dev))
-    {
-        return -1;
-    }
-
-    /* activate SPI mode */
-    spi->I2SCFGR &= ~(SPI_I2SCFGR_I2SMOD);
-    spi->CR1 = 0;
-    spi->CR2 = 0;
-    spi->CR1 |= (baud << SPI_CR1_BR_SHIFT);
-    spi->CR1 |= SPI_CR1_MSTR;
-    /* NSS (chip select) managed by software and NSS is low (slave enabled)*/
-    spi->CR1 |= SPI_CR1_SSM;
-    spi->CR1 |= SPI_CR1_SSI;
-    spi->CR1 |= SPI_CR1_CPOL;
-    spi->CR1 |= SPI_CR1_CPHA;
-    spi->CR1 |= SPI_CR1_SPE;
-
-    return 0;
-}
-
-int spi_conf_pins(spi_t dev)
-{
-    GPIO_TypeDef *port[3];
-    int hl, i, pin[3], af[3];
-
-    switch (dev)
-    {
-#if SPI_0_EN
-        case SPI_0:
-            port[0] = SPI_0_SCK_PORT;
-            pin[0] = SPI_0_SCK_PIN;
-            af[0] = SPI_0_SCK_AF;
-            port[1] = SPI_0_MOSI_PORT;
-            pin[1] = SPI_0_MOSI_PIN;
-            af[1] = SPI_0_MOSI_AF;
-            port[2] = SPI_0_MISO_PORT;
-            pin[2] = SPI_0_MISO_PIN;
-            af[2] = SPI_0_MISO_AF;
-            break;
-#endif /* SPI_0_EN */
-        default:
-            return 1;
-    }
-
-    for (i = 0; i < 3; i++)
-    {
-        /* Set GPIOs to AF mode */
-        port[i]->MODER &= ~(3 << (2 * pin[i]));
-        port[i]->MODER |= (GPIO_MODE_AF << (2 * pin[i]));
-        /* Set speed */
-        port[i]->OSPEEDR &= ~(3 << (2 * pin[i]));
-        port[i]->OSPEEDR |= (GPIO_SPEED_HIGH << (2 * pin[i]));
-        /* Set to push-pull configuration */
-        port[i]->OTYPER &= ~(GPIO_OT_OPENDRAIN << pin[i]);
-        /* Configure push-pull resistors */
-        port[i]->PUPDR &= ~(3 << (2 * pin[i]));
-        port[i]->PUPDR |= (GPIO_PULLDOWN << (2 * pin[i]));
-        /* Configure GPIOs for the SPI alternate function */
-        hl = (pin[i] < 8) ? 0 : 1;
-        port[i]->AFR[hl] &= ~(0xf << ((pin[i] - (hl * 8)) * 4));
-        port[i]->AFR[hl] |= (af[i] << ((pin[i] - (hl * 8)) * 4));
-    }
-
-    return 0;
-}
-
-int spi_acquire(spi_t dev)
-{
-    return -1;
-}
-
-int spi_release(spi_t dev)
-{
-    return -1;
-}
-
-void spi_transfer_byte(spi_t dev, unsigned char out, unsigned char *in)
-{
-    char val;
-    SPI_TypeDef *spi;
-
-    switch (dev)
-    {
-#if SPI_0_EN
-        case SPI_0:
-        spi = SPI_0_DEV;
-#endif
-    }
-
-    /* wait for an eventually previous byte to be finished transferred */
-    while(!(spi->SR & SPI_SR_TXE))
-    {
-        /* Do nothing here. */
-    };
-
-    /* put next byte into the output register */
-    spi->DR = (char) out;
-
-    /* wait until the current byte was successfully transferred */
-    while(!(spi->SR & SPI_SR_RXNE))
-    {
-        /* Do nothing here. */
-    };
-
-    /* read response byte to reset flags */
-    val = spi->DR;
-
-    /* 'return' response byte if wished for */
-    if (in != NULL)
-    {
-        *in = (unsigned char) val;
-    }
-}
-
-void spi_poweron(spi_t dev)
-{
-    switch (dev)
-    {
-#if SPI_0_EN
-        case SPI_0:
-            while (SPI_0_DEV->SR & SPI_SR_BSY);
-            SPI_0_CLKEN();
-            break;
-#endif
-    }
-}
-
-void spi_poweroff(spi_t dev)
-{
-    switch (dev)
-    {
-#if SPI_0_EN
-        case SPI_0:
-            while (SPI_0_DEV->SR & SPI_SR_BSY);
-            SPI_0_CLKDIS();
-            break;
-#endif
-    }
-}
+/**
+ * @{
+ *
+ * @brief     Low-level peripheral driver for DAC.
+ * @author    Copyright (C) Rene Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stm32f4xx.h>
+
+#include "driver/spi.h"
+#include "driver/gpio.h"
+
+#include "driver/debug.h"
+
+/** Byte sent while only receiving */
+#define SPI_DUMMY            (0xFF)
+/** Shifts to bit 3 baud bit in CR1 register */
+#define SPI_CR1_BR_SHIFT     (3)
+/** Shifts to the channel select bits in the DMA stream CR register */
+#define DMA_SxCR_CHSEL_SHIFT (25)
+/** Smallest block which spi_transfer_buf() moves via DMA */
+#define SPI_DMA_MIN          (32)
+
+/** Type for DMA transfer state */
+typedef struct {
+    spi_cb_t cb;           /**< callback for the finished transfer */
+    void *arg;             /**< argument of the callback */
+    volatile uint8_t busy; /**< flag if a transfer is running */
+} spi_dma_t;
+
+/** DMA transfer state memory */
+static spi_dma_t dma_state[SPI_NUMOF];
+
+/** Flags of the buses owned via spi_acquire() */
+static volatile uint8_t bus_locked[SPI_NUMOF];
+
+/** Source and sink for the not needed direction of a DMA transfer */
+static const unsigned char dma_dummy_out = 0xFF;
+static unsigned char dma_dummy_in;
+
+int spi_init_master(spi_t dev, spi_baud_t baud)
+{
+    SPI_TypeDef *spi;
+
+    switch (dev)
+    {
+#if SPI_0_EN
+        case SPI_0:
+            spi = SPI_0_DEV;
+            SPI_0_CLKEN();
+            SPI_0_SCK_PORT_CLKEN();
+            SPI_0_MISO_PORT_CLKEN();
+            SPI_0_MOSI_PORT_CLKEN();
+            SPI_0_DMA_CLKEN();
+            NVIC_SetPriority(SPI_0_DMA_RX_IRQ, 2);
+            NVIC_EnableIRQ(SPI_0_DMA_RX_IRQ);
+            break;
+#endif /* SPI_0_EN */
+        default:
+            return -1;
+    }
+
+    if (spi_conf_pins(dev))
+    {
+        return -1;
+    }
+
+    /* activate SPI mode */
+    spi->I2SCFGR &= ~(SPI_I2SCFGR_I2SMOD);
+    spi->CR1 = 0;
+    spi->CR2 = 0;
+    spi->CR1 |= (baud << SPI_CR1_BR_SHIFT);
+    spi->CR1 |= SPI_CR1_MSTR;
+    /* NSS (chip select) managed by software and NSS is low (slave enabled)*/
+    spi->CR1 |= SPI_CR1_SSM;
+    spi->CR1 |= SPI_CR1_SSI;
+    spi->CR1 |= SPI_CR1_CPOL;
+    spi->CR1 |= SPI_CR1_CPHA;
+    spi->CR1 |= SPI_CR1_SPE;
+
+    return 0;
+}
+
+int spi_conf_pins(spi_t dev)
+{
+    GPIO_TypeDef *port[3];
+    int hl, i, pin[3], af[3];
+
+    switch (dev)
+    {
+#if SPI_0_EN
+        case SPI_0:
+            port[0] = SPI_0_SCK_PORT;
+            pin[0] = SPI_0_SCK_PIN;
+            af[0] = SPI_0_SCK_AF;
+            port[1] = SPI_0_MOSI_PORT;
+            pin[1] = SPI_0_MOSI_PIN;
+            af[1] = SPI_0_MOSI_AF;
+            port[2] = SPI_0_MISO_PORT;
+            pin[2] = SPI_0_MISO_PIN;
+            af[2] = SPI_0_MISO_AF;
+            break;
+#endif /* SPI_0_EN */
+        default:
+            return 1;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        /* Set GPIOs to AF mode */
+        port[i]->MODER &= ~(3 << (2 * pin[i]));
+        port[i]->MODER |= (GPIO_MODE_AF << (2 * pin[i]));
+        /* Set speed */
+        port[i]->OSPEEDR &= ~(3 << (2 * pin[i]));
+        port[i]->OSPEEDR |= (GPIO_SPEED_HIGH << (2 * pin[i]));
+        /* Set to push-pull configuration */
+        port[i]->OTYPER &= ~(GPIO_OT_OPENDRAIN << pin[i]);
+        /* Configure push-pull resistors */
+        port[i]->PUPDR &= ~(3 << (2 * pin[i]));
+        port[i]->PUPDR |= (GPIO_PULLDOWN << (2 * pin[i]));
+        /* Configure GPIOs for the SPI alternate function */
+        hl = (pin[i] < 8) ? 0 : 1;
+        port[i]->AFR[hl] &= ~(0xf << ((pin[i] - (hl * 8)) * 4));
+        port[i]->AFR[hl] |= (af[i] << ((pin[i] - (hl * 8)) * 4));
+    }
+
+    return 0;
+}
+
+int spi_acquire(spi_t dev)
+{
+    uint32_t primask;
+    int status = -1;
+
+    if (dev >= SPI_NUMOF)
+    {
+        return -1;
+    }
+
+    /* test and set without being interrupted */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (!bus_locked[dev])
+    {
+        bus_locked[dev] = 1;
+        status = 0;
+    }
+
+    __set_PRIMASK(primask);
+
+    return status;
+}
+
+int spi_release(spi_t dev)
+{
+    if (dev >= SPI_NUMOF)
+    {
+        return -1;
+    }
+
+    bus_locked[dev] = 0;
+
+    return 0;
+}
+
+void spi_transfer_byte(spi_t dev, unsigned char out, unsigned char *in)
+{
+    char val;
+    SPI_TypeDef *spi;
+
+    switch (dev)
+    {
+#if SPI_0_EN
+        case SPI_0:
+        spi = SPI_0_DEV;
+#endif
+    }
+
+    /* wait for an eventually previous byte to be finished transferred */
+    while(!(spi->SR & SPI_SR_TXE))
+    {
+        /* Do nothing here. */
+    };
+
+    /* put next byte into the output register */
+    spi->DR = (char) out;
+
+    /* wait until the current byte was successfully transferred */
+    while(!(spi->SR & SPI_SR_RXNE))
+    {
+        /* Do nothing here. */
+    };
+
+    /* read response byte to reset flags */
+    val = spi->DR;
+
+    /* 'return' response byte if wished for */
+    if (in != NULL)
+    {
+        *in = (unsigned char) val;
+    }
+}
+
+/**
+ * @brief Checks if the DMA can access a buffer, the CCM RAM is not connected
+ */
+static int _dma_able(const void *ptr)
+{
+    return (ptr == NULL) || ((uint32_t)ptr >= SRAM1_BASE);
+}
+
+int spi_transfer_buf(spi_t dev, const unsigned char *out, unsigned char *in, int len)
+{
+    SPI_TypeDef *spi;
+    uint32_t primask;
+    int tx, rx;
+    unsigned char val;
+
+    switch (dev)
+    {
+#if SPI_0_EN
+        case SPI_0:
+            spi = SPI_0_DEV;
+            break;
+#endif
+        default:
+            return -1;
+    }
+
+    /* the data register belongs to a running DMA transfer */
+    if (dma_state[dev].busy)
+    {
+        return -1;
+    }
+
+    if (len <= 0)
+    {
+        return 0;
+    }
+
+    /* bulk transfers of the thread mode go via DMA, the DMA interrupt ends them */
+    if ((len >= SPI_DMA_MIN) && (len <= 0xFFFF) && (__get_IPSR() == 0) &&
+        _dma_able(out) && _dma_able(in) &&
+        (spi_transfer_dma(dev, out, in, (uint16_t)len, NULL, NULL) == 0))
+    {
+        while (dma_state[dev].busy);
+        return 0;
+    }
+
+    if (in == NULL)
+    {
+        /* transmit only: refill the TX register whenever it is empty */
+        for (tx = 0; tx < len; tx++)
+        {
+            while (!(spi->SR & SPI_SR_TXE));
+            spi->DR = (out != NULL) ? out[tx] : SPI_DUMMY;
+        }
+
+        /* wait for the last byte to be shifted out */
+        while (!(spi->SR & SPI_SR_TXE));
+        while (spi->SR & SPI_SR_BSY);
+
+        /* drop the received bytes and clear the overrun flag */
+        val = spi->DR;
+        val = spi->SR;
+        (void) val;
+        return 0;
+    }
+
+    /* the TX register stays one byte ahead, so the bus does not idle between
+     * the bytes. Interrupts are held off from loading the next byte until the
+     * current one is read, a delay there would overrun the receiver. */
+    while (!(spi->SR & SPI_SR_TXE));
+    spi->DR = (out != NULL) ? out[0] : SPI_DUMMY;
+
+    for (rx = 0; rx < len; rx++)
+    {
+        tx = rx + 1;
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        if (tx < len)
+        {
+            while (!(spi->SR & SPI_SR_TXE));
+            spi->DR = (out != NULL) ? out[tx] : SPI_DUMMY;
+        }
+
+        while (!(spi->SR & SPI_SR_RXNE));
+        in[rx] = spi->DR;
+
+        __set_PRIMASK(primask);
+    }
+
+    /* a lost byte (e.g. a halted core) clears the flag and fails the transfer,
+     * the caller repeats the command */
+    if (spi->SR & SPI_SR_OVR)
+    {
+        val = spi->DR;
+        val = spi->SR;
+        (void) val;
+        return -1;
+    }
+
+    return 0;
+}
+
+int spi_transfer_dma(spi_t dev, const unsigned char *out, unsigned char *in,
+                     uint16_t len, spi_cb_t cb, void *arg)
+{
+    SPI_TypeDef *spi;
+    DMA_Stream_TypeDef *rx, *tx;
+    uint32_t chan;
+
+    switch (dev)
+    {
+#if SPI_0_EN
+        case SPI_0:
+            spi = SPI_0_DEV;
+            rx = SPI_0_DMA_RX_STREAM;
+            tx = SPI_0_DMA_TX_STREAM;
+            chan = SPI_0_DMA_CHAN;
+            SPI_0_DMA_RX_IFCR = SPI_0_DMA_RX_FLAGS;
+            SPI_0_DMA_TX_IFCR = SPI_0_DMA_TX_FLAGS;
+            break;
+#endif
+        default:
+            return -1;
+    }
+
+    if ((len == 0) || dma_state[dev].busy)
+    {
+        return -1;
+    }
+
+    dma_state[dev].busy = 1;
+    dma_state[dev].cb = cb;
+    dma_state[dev].arg = arg;
+
+    /* wait for the streams to be disabled from a previous transfer */
+    while ((rx->CR & DMA_SxCR_EN) || (tx->CR & DMA_SxCR_EN));
+
+    /* receive stream: peripheral to memory, signals the end of the transfer */
+    rx->PAR = (uint32_t) &spi->DR;
+    rx->M0AR = (uint32_t) ((in != NULL) ? in : &dma_dummy_in);
+    rx->NDTR = len;
+    rx->FCR = 0;
+    rx->CR = (chan << DMA_SxCR_CHSEL_SHIFT) | DMA_SxCR_PL_1 | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    if (in != NULL)
+    {
+        rx->CR |= DMA_SxCR_MINC;
+    }
+
+    /* transmit stream: memory to peripheral */
+    tx->PAR = (uint32_t) &spi->DR;
+    tx->M0AR = (uint32_t) ((out != NULL) ? out : &dma_dummy_out);
+    tx->NDTR = len;
+    tx->FCR = 0;
+    tx->CR = (chan << DMA_SxCR_CHSEL_SHIFT) | DMA_SxCR_PL_0 | DMA_SxCR_DIR_0;
+    if (out != NULL)
+    {
+        tx->CR |= DMA_SxCR_MINC;
+    }
+
+    /* drop an eventually unread byte, then start rx before tx */
+    (void) spi->DR;
+    spi->CR2 |= SPI_CR2_RXDMAEN;
+    rx->CR |= DMA_SxCR_EN;
+    tx->CR |= DMA_SxCR_EN;
+    spi->CR2 |= SPI_CR2_TXDMAEN;
+
+    return 0;
+}
+
+#if SPI_0_EN
+void SPI_0_DMA_RX_ISR(void)
+{
+    spi_dma_t *state = &dma_state[SPI_0];
+    int status = 0;
+
+    if (!(SPI_0_DMA_RX_ISR_REG & SPI_0_DMA_RX_TCIF))
+    {
+        /* transfer error, should not happen, the streams are stopped */
+        SPI_0_DMA_RX_STREAM->CR &= ~DMA_SxCR_EN;
+        SPI_0_DMA_TX_STREAM->CR &= ~DMA_SxCR_EN;
+        status = -1;
+    }
+
+    SPI_0_DMA_RX_IFCR = SPI_0_DMA_RX_FLAGS;
+    SPI_0_DMA_TX_IFCR = SPI_0_DMA_TX_FLAGS;
+    SPI_0_DEV->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+    state->busy = 0;
+
+    if (state->cb != NULL)
+    {
+        state->cb(state->arg, status);
+    }
+}
+#endif /* SPI_0_EN */
+
+void spi_poweron(spi_t dev)
+{
+    switch (dev)
+    {
+#if SPI_0_EN
+        case SPI_0:
+            while (SPI_0_DEV->SR & SPI_SR_BSY);
+            SPI_0_CLKEN();
+            break;
+#endif
+    }
+}
+
+void spi_poweroff(spi_t dev)
+{
+    switch (dev)
+    {
+#if SPI_0_EN
+        case SPI_0:
+            while (SPI_0_DEV->SR & SPI_SR_BSY);
+            SPI_0_CLKDIS();
+            break;
+#endif
+    }
+}
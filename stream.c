@@ -0,0 +1,318 @@
+/**
+ * @{
+ *
+ * @brief     Live MP3 stream over the UART with an adaptive jitter buffer
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "include/stream.h"
+#include "include/inbuf.h"
+#include "driver/uart.h"
+#include "driver/define/at25df641_def.h"
+
+/** Device which receives the stream */
+#define STREAM_UART     (UART_1)
+/** Largest fill level, a decoder block has to fit behind it */
+#define FILL_MAX        (INBUF_SIZE - INBUF_GUARD)
+
+/** Receive ring of the DMA */
+static unsigned char ring[STREAM_RX_SIZE];
+
+/**
+ * @brief State of the stream
+ */
+static struct {
+    int state;                  /**< STREAM_x */
+    inbuf_t *buf;               /**< input buffer of the decoder */
+    uint16_t rx_pos;            /**< last DMA position in the ring */
+    volatile uint32_t now;      /**< ms, counted by stream_tick() */
+    uint32_t last_rx;           /**< time of the last received data */
+    uint32_t window;            /**< start of the window */
+    int min_fill;               /**< lowest fill level in the window */
+    int need;                   /**< bytes of the decoder, from stream_ready() */
+    int bitrate;                /**< bitrate of the stream */
+    int target_ms;              /**< fill level which is buffered before playing */
+    int ended;                  /**< flag if no data came for STREAM_TIMEOUT_MS */
+    int trim;                   /**< flag if frames are dropped down to the target */
+    int starved;                /**< flag if the buffer ran empty, maybe at the end */
+    stream_stats_t stats;       /**< counters of the stream */
+} st;
+
+/**
+ * @brief Converts playback time of the stream into bytes
+ */
+static int _bytes(int ms)
+{
+    return (int)(((int64_t)st.bitrate * ms) / (8 * 1000));
+}
+
+/**
+ * @brief Returns the target in bytes, at least one decoder block
+ */
+static int _target(void)
+{
+    int target = _bytes(st.target_ms);
+
+    target = (target > st.need) ? target : st.need;
+
+    return MINIMUM(target, FILL_MAX);
+}
+
+/**
+ * @brief Starts a new window for the lowest fill level
+ */
+static void _new_window(void)
+{
+    st.window = st.now;
+    st.min_fill = INBUF_SIZE;
+}
+
+/**
+ * @brief Copies the received bytes into the input buffer
+ *
+ * If the input buffer is full, the rest is dropped. The decoder finds the
+ * next frame behind the gap.
+ */
+static void _rx(void)
+{
+    uint16_t pos = uart_rx_pos(STREAM_UART);
+    uint32_t n = (pos + STREAM_RX_SIZE - st.rx_pos) % STREAM_RX_SIZE;
+    unsigned char *ptr;
+    int len;
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    st.last_rx = st.now;
+    st.ended = 0;
+    st.stats.received += n;
+
+    /* the stream goes on, so running empty was an underrun */
+    if (st.starved)
+    {
+        st.starved = 0;
+        st.stats.underruns++;
+
+        if (_bytes(st.target_ms + STREAM_STEP_MS) <= FILL_MAX)
+        {
+            st.target_ms += STREAM_STEP_MS;
+        }
+    }
+
+    while (n > 0)
+    {
+        ptr = inbuf_write_ptr(st.buf, &len);
+
+        if (len == 0)
+        {
+            st.stats.overruns++;
+            st.rx_pos = pos;
+            return;
+        }
+
+        len = (int)MINIMUM((uint32_t)len, MINIMUM(n, (uint32_t)(STREAM_RX_SIZE - st.rx_pos)));
+        memcpy(ptr, &ring[st.rx_pos], len);
+        inbuf_commit(st.buf, len);
+
+        st.rx_pos = (st.rx_pos + len) % STREAM_RX_SIZE;
+        n -= len;
+    }
+}
+
+/**
+ * @brief Lowers the target after a window in which part of it was never needed
+ */
+static void _adapt(int fill)
+{
+    st.min_fill = (fill < st.min_fill) ? fill : st.min_fill;
+
+    if ((st.now - st.window) < STREAM_WINDOW_MS)
+    {
+        return;
+    }
+
+    /* the buffer always held a step more than the decoder needed */
+    if (((st.min_fill - st.need) > _bytes(STREAM_STEP_MS)) &&
+        (st.target_ms > STREAM_TARGET_MIN))
+    {
+        st.target_ms -= STREAM_STEP_MS;
+        st.trim = 1;
+    }
+
+    /* the sender is faster than the output */
+    if (st.min_fill > _target())
+    {
+        st.trim = 1;
+    }
+
+    _new_window();
+}
+
+int stream_init(void)
+{
+    memset(&st, 0, sizeof st);
+    st.state = STREAM_IDLE;
+
+    if ((uart_init(STREAM_UART, STREAM_BAUD) != 0) ||
+        (uart_rx_start(STREAM_UART, ring, STREAM_RX_SIZE) != 0))
+    {
+        return ERROR_DEFAULT;
+    }
+
+    return OK;
+}
+
+void stream_tick(void)
+{
+    st.now++;
+}
+
+int stream_poll(void)
+{
+    uint16_t pos;
+    int fill;
+
+    switch (st.state)
+    {
+        case STREAM_IDLE:
+            /* any byte starts a new stream */
+            return (uart_rx_pos(STREAM_UART) != st.rx_pos) ? STREAM_EV_START : STREAM_EV_NONE;
+        case STREAM_FLUSH:
+            if ((pos = uart_rx_pos(STREAM_UART)) != st.rx_pos)
+            {
+                st.rx_pos = pos;
+                st.last_rx = st.now;
+            }
+            else if ((st.now - st.last_rx) >= STREAM_TIMEOUT_MS)
+            {
+                st.state = STREAM_IDLE;
+            }
+            return STREAM_EV_NONE;
+        default:
+            break;
+    }
+
+    _rx();
+    fill = inbuf_fill(st.buf);
+
+    if ((st.now - st.last_rx) >= STREAM_TIMEOUT_MS)
+    {
+        st.ended = 1;
+    }
+
+    if ((st.state == STREAM_BUFFERING) && ((fill >= _target()) || st.ended))
+    {
+        st.state = STREAM_PLAYING;
+        _new_window();
+    }
+
+    if (st.state == STREAM_PLAYING)
+    {
+        if (st.ended && (fill == 0))
+        {
+            st.state = STREAM_IDLE;
+            return STREAM_EV_END;
+        }
+
+        _adapt(fill);
+    }
+
+    return STREAM_EV_NONE;
+}
+
+void stream_start(inbuf_t *buf)
+{
+    inbuf_reset(buf);
+    memset(&st.stats, 0, sizeof st.stats);
+
+    st.buf = buf;
+    st.state = STREAM_BUFFERING;
+    st.last_rx = st.now;
+    st.need = 0;
+    st.bitrate = STREAM_BITRATE;
+    st.target_ms = STREAM_TARGET_MS;
+    st.ended = 0;
+    st.trim = 0;
+    st.starved = 0;
+}
+
+void stream_stop(void)
+{
+    if (st.state != STREAM_IDLE)
+    {
+        st.state = STREAM_FLUSH;
+        st.last_rx = st.now;
+    }
+}
+
+int stream_ready(int bytes)
+{
+    int fill;
+
+    if ((st.state != STREAM_BUFFERING) && (st.state != STREAM_PLAYING))
+    {
+        return 0;
+    }
+
+    st.need = bytes;
+    fill = inbuf_fill(st.buf);
+
+    if (st.state != STREAM_PLAYING)
+    {
+        return 0;
+    }
+
+    if ((fill >= bytes) || (st.ended && (fill > 0)))
+    {
+        return 1;
+    }
+
+    /* the sender fell behind or the stream ends, _rx() tells which */
+    st.state = STREAM_BUFFERING;
+    st.starved = 1;
+    st.trim = 0;
+
+    return 0;
+}
+
+int stream_skip(void)
+{
+    if (st.trim && (st.state == STREAM_PLAYING) && (inbuf_fill(st.buf) > _target()))
+    {
+        st.stats.dropped++;
+        return 1;
+    }
+
+    st.trim = 0;
+
+    return 0;
+}
+
+void stream_set_bitrate(int bitrate)
+{
+    if (bitrate > 0)
+    {
+        st.bitrate = bitrate;
+    }
+}
+
+void stream_stats(stream_stats_t *stats)
+{
+    *stats = st.stats;
+    stats->state = st.state;
+    stats->target_ms = st.target_ms;
+    stats->fill_ms = 0;
+
+    if ((st.buf != NULL) && ((st.state == STREAM_BUFFERING) || (st.state == STREAM_PLAYING)))
+    {
+        stats->fill_ms = (uint32_t)(((int64_t)inbuf_fill(st.buf) * 8 * 1000) / st.bitrate);
+    }
+}
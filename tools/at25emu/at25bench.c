@@ -0,0 +1,504 @@
+/**
+ * @{
+ *
+ * @brief     Runs the flash driver against two emulated AT25DF641 chips
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Build from the root of the repository:
+ *
+ *   gcc -O2 -pthread -Itools/at25emu -I. -o at25bench tools/at25emu/at25emu.c \
+ *       tools/at25emu/host.c tools/at25emu/at25bench.c at25df641.c
+ *
+ * Usage: at25bench [-s spi_hz] [-p page_us] [-e erase4k_us] work.img orig.img
+ *
+ * work.img is changed, orig.img is only read. All times are emulated times
+ * of the bus and the timing model, not the time of the host.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "at25emu.h"
+#include "driver/at25df641.h"
+#include "driver/spi.h"
+#include "driver/define/at25df641_def.h"
+
+/** Bytes of the read measurements */
+#define READ_BYTES      (1024 * 1024)
+
+/** Bytes of one read call */
+#define READ_CHUNK      (4096)
+
+/** Reads of the cache measurement */
+#define CACHE_READS     (4096)
+
+/** Playback reads of the queue measurement */
+#define QUEUE_READS     (16)
+
+/** Block which is erased and programmed in the background */
+#define PE_ADDR         (0x7E0000)
+
+/** Bytes read per call while programming */
+#define PE_READ         (256)
+
+/** Bytes of one small write, like a log record */
+#define APPEND_SIZE     (32)
+
+/** Bytes appended per measurement */
+#define APPEND_BYTES    (16 * 1024)
+
+/** Period of the flash tick in ns */
+#define TICK_NS         (1000000ULL)
+
+static unsigned char buf[READ_BYTES];
+static unsigned char pattern[AT25DF641_BLOCK_SIZE];
+
+static volatile int async_done;
+static volatile int pe_done;
+static volatile int pe_status;
+static uint64_t next_tick;
+
+/**
+ * @brief Plays the 1ms timer interrupt of the flash engine
+ *
+ * Called between the reads, ticks which were missed meanwhile are served
+ * with one call like a pending interrupt.
+ */
+static void _tick(void)
+{
+    uint64_t now = at25emu_time_ns();
+
+    if (now >= next_tick)
+    {
+        at25df641_tick();
+        next_tick = now - (now % TICK_NS) + TICK_NS;
+    }
+}
+
+static void _async_cb(void *arg, int status)
+{
+    (void)arg;
+    (void)status;
+    async_done = 1;
+}
+
+static void _pe_cb(void *arg, int status)
+{
+    (void)arg;
+    pe_status = status;
+    pe_done = 1;
+}
+
+/**
+ * @brief Prints a rate of bytes in the emulated time
+ */
+static void _rate(const char *name, uint32_t bytes, uint64_t ns)
+{
+    printf("%-22s %8u bytes %10.3f ms %8.3f MB/s\n", name, bytes, ns / 1e6,
+           ns ? (bytes * 1e3) / ns : 0.0);
+}
+
+/**
+ * @brief Measures the blocking reads with one read mode
+ */
+static void _bench_read(const char *name, at25df641_read_t mode)
+{
+    uint64_t t0;
+    uint32_t i;
+
+    at25df641_set_read_mode(AT25DF641_1, mode);
+    t0 = at25emu_time_ns();
+
+    for (i = 0; i < READ_BYTES; i += READ_CHUNK)
+    {
+        at25df641_read(AT25DF641_1, &buf[i], READ_CHUNK, i);
+    }
+
+    _rate(name, READ_BYTES, at25emu_time_ns() - t0);
+    at25df641_set_read_mode(AT25DF641_1, READ_FAST);
+}
+
+/**
+ * @brief Measures the DMA read and the streaming read
+ */
+static void _bench_async(void)
+{
+    uint64_t t0;
+    uint32_t i;
+
+    async_done = 0;
+    t0 = at25emu_time_ns();
+
+    if (at25df641_read_async(AT25DF641_1, buf, READ_BYTES, 0, _async_cb, NULL) == OK)
+    {
+        while (!async_done);
+        _rate("read_async", READ_BYTES, at25emu_time_ns() - t0);
+    }
+
+    at25df641_stream_open(AT25DF641_1, 0);
+    t0 = at25emu_time_ns();
+
+    for (i = 0; i < READ_BYTES; i += READ_CHUNK)
+    {
+        at25df641_stream_read(AT25DF641_1, &buf[i], READ_CHUNK);
+    }
+
+    _rate("stream_read", READ_BYTES, at25emu_time_ns() - t0);
+    at25df641_stream_close(AT25DF641_1);
+}
+
+/**
+ * @brief Measures small scattered reads like seek index lookups
+ */
+static void _bench_cache(void)
+{
+    at25df641_cache_stats_t before, after;
+    uint32_t seed = 1, addr;
+    uint64_t t0;
+    int i;
+
+    at25df641_cache_stats(&before);
+    t0 = at25emu_time_ns();
+
+    for (i = 0; i < CACHE_READS; i++)
+    {
+        /* 64 entries of 36 bytes in a few pages */
+        seed = seed * 1103515245 + 12345;
+        addr = 0x1000 + ((seed >> 16) % 64) * 36;
+        at25df641_read(AT25DF641_1, buf, 36, addr);
+    }
+
+    at25df641_cache_stats(&after);
+    printf("%-22s %8u reads %10.3f ms %8lu hits %lu misses\n", "cached 36 byte reads", CACHE_READS,
+           (at25emu_time_ns() - t0) / 1e6, (unsigned long)(after.hits - before.hits),
+           (unsigned long)(after.misses - before.misses));
+}
+
+/**
+ * @brief Waits for the background operation, reading the same chip meanwhile
+ *
+ * @param[in] base      first address of the reads
+ * @param[in] span      bytes behind base which are read in turn
+ *
+ * @return              longest read in ns
+ */
+static uint64_t _pe_wait_reading(int *reads, uint32_t base, uint32_t span)
+{
+    uint64_t t0, t, worst = 0;
+    uint32_t addr = 0;
+
+    *reads = 0;
+
+    while (!pe_done)
+    {
+        t0 = at25emu_time_ns();
+        at25df641_read(AT25DF641_0, buf, PE_READ, base + addr);
+        t = at25emu_time_ns() - t0;
+
+        worst = (t > worst) ? t : worst;
+        addr = (addr + PE_READ) % span;
+        (*reads)++;
+
+        /* some time of the decoder between the reads, the timer in between */
+        at25emu_idle_until(at25emu_time_ns() + 100000);
+        _tick();
+        at25emu_idle_until(at25emu_time_ns() + 100000);
+    }
+
+    return worst;
+}
+
+/**
+ * @brief Erases and programs one block in the background while reading
+ */
+static void _bench_pe(void)
+{
+    at25emu_stats_t before, after;
+    uint64_t t0, worst;
+    int i, reads;
+
+    for (i = 0; i < AT25DF641_BLOCK_SIZE; i++)
+    {
+        pattern[i] = (unsigned char)(i * 7);
+    }
+
+    next_tick = at25emu_time_ns();
+
+    /* brings the first page into the read cache */
+    at25df641_read(AT25DF641_0, buf, 16, PE_ADDR);
+
+    pe_done = 0;
+    t0 = at25emu_time_ns();
+    at25df641_erase_async(AT25DF641_0, PE_ADDR, BLOCK_ERASE_64KB, _pe_cb, NULL);
+    worst = _pe_wait_reading(&reads, 0, PE_ADDR);
+    printf("erase_async 64KB       %10.3f ms status %d, %d reads, longest %.3f ms\n",
+           (at25emu_time_ns() - t0) / 1e6, pe_status, reads, worst / 1e6);
+
+    pe_done = 0;
+    t0 = at25emu_time_ns();
+    at25df641_write_async(AT25DF641_0, pattern, sizeof pattern, PE_ADDR, _pe_cb, NULL);
+    worst = _pe_wait_reading(&reads, 0, PE_ADDR);
+    printf("write_async 64KB       %10.3f ms status %d, %d reads, longest %.3f ms\n",
+           (at25emu_time_ns() - t0) / 1e6, pe_status, reads, worst / 1e6);
+
+    at25df641_read(AT25DF641_0, buf, sizeof pattern, PE_ADDR);
+    printf("written block          %s\n", memcmp(buf, pattern, sizeof pattern) ? "DIFFERENT" : "equal");
+
+    at25df641_read(AT25DF641_0, buf, 16, PE_ADDR);
+    printf("cached page            %s\n", memcmp(buf, pattern, 16) ? "STALE" : "equal");
+
+    /* like the PCM cache: replay reads of the sector which is programmed */
+    pe_done = 0;
+    at25df641_erase_async(AT25DF641_0, PE_ADDR, BLOCK_ERASE_64KB, _pe_cb, NULL);
+    _pe_wait_reading(&reads, 0, PE_ADDR);
+
+    at25emu_stats(0, &before);
+    pe_done = 0;
+    t0 = at25emu_time_ns();
+    at25df641_write_async(AT25DF641_0, pattern, sizeof pattern, PE_ADDR, _pe_cb, NULL);
+    worst = _pe_wait_reading(&reads, PE_ADDR, sizeof pattern);
+    at25emu_stats(0, &after);
+    printf("write_async same 64KB  %10.3f ms status %d, %d reads, longest %.3f ms, %llu violations\n",
+           (at25emu_time_ns() - t0) / 1e6, pe_status, reads, worst / 1e6,
+           (unsigned long long)(after.violations - before.violations));
+}
+
+static volatile int queue_reads;
+static volatile uint64_t queue_reads_ns;
+static volatile int queue_writes;
+
+static void _queue_read_cb(void *arg, int status)
+{
+    (void)status;
+
+    if (++queue_reads == QUEUE_READS)
+    {
+        queue_reads_ns = at25emu_time_ns();
+    }
+
+    /* one playback read at a time, like the read-ahead */
+    if (arg != NULL)
+    {
+        at25df641_submit(arg);
+    }
+}
+
+static void _queue_write_cb(void *arg, int status)
+{
+    (void)arg;
+    pe_status = status;
+    queue_writes++;
+}
+
+/**
+ * @brief Queues an erase and program of the work chip and playback reads
+ *
+ * The reads of the original chip go on while the work chip is busy.
+ */
+static void _bench_queue(void)
+{
+    static at25df641_trans_t trans[QUEUE_READS + 2];
+    uint64_t t0;
+    int i;
+
+    memset(trans, 0, sizeof trans);
+    queue_reads = 0;
+    queue_writes = 0;
+    next_tick = at25emu_time_ns();
+    t0 = at25emu_time_ns();
+
+    for (i = 0; i < 2; i++)
+    {
+        trans[i].type = i ? TRANS_WRITE : TRANS_ERASE;
+        trans[i].prio = PRIO_BACKGROUND;
+        trans[i].dev = AT25DF641_0;
+        trans[i].erase_cmd = BLOCK_ERASE_64KB;
+        trans[i].data = i ? pattern : NULL;
+        trans[i].addr = PE_ADDR;
+        trans[i].size = i ? sizeof pattern : 0;
+        trans[i].cb = _queue_write_cb;
+        at25df641_submit(&trans[i]);
+    }
+
+    for (i = 2; i < (QUEUE_READS + 2); i++)
+    {
+        trans[i].type = TRANS_READ;
+        trans[i].prio = PRIO_PLAYBACK;
+        trans[i].dev = AT25DF641_1;
+        trans[i].data = &buf[(i - 2) * READ_CHUNK];
+        trans[i].addr = (i - 2) * READ_CHUNK;
+        trans[i].size = READ_CHUNK;
+        trans[i].cb = _queue_read_cb;
+        trans[i].arg = (i < (QUEUE_READS + 1)) ? &trans[i + 1] : NULL;
+    }
+
+    at25df641_submit(&trans[2]);
+
+    while ((queue_reads < QUEUE_READS) || (queue_writes < 2))
+    {
+        /* the chained reads advance the time, idling would run ahead of them */
+        if (queue_reads == QUEUE_READS)
+        {
+            at25emu_idle_until(at25emu_time_ns() + 100000);
+        }
+
+        _tick();
+    }
+
+    printf("queue                  %10.3f ms %d reads done after %.3f ms, erase and program status %d\n",
+           (at25emu_time_ns() - t0) / 1e6, queue_reads, (queue_reads_ns - t0) / 1e6, pe_status);
+
+    at25df641_read(AT25DF641_0, buf, sizeof pattern, PE_ADDR);
+    printf("queued block           %s\n", memcmp(buf, pattern, sizeof pattern) ? "DIFFERENT" : "equal");
+}
+
+/**
+ * @brief Appends small records directly and through the write-combining buffer
+ */
+static void _bench_append(void)
+{
+    at25df641_wcb_stats_t before, after;
+    uint64_t t0, t;
+    uint32_t i;
+
+    at25df641_erase_block(AT25DF641_0, PE_ADDR, BLOCK_ERASE_64KB);
+    t0 = at25emu_time_ns();
+
+    for (i = 0; i < APPEND_BYTES; i += APPEND_SIZE)
+    {
+        at25df641_write(AT25DF641_0, &pattern[i], APPEND_SIZE, PE_ADDR + i);
+    }
+
+    _rate("write 32 byte appends", APPEND_BYTES, at25emu_time_ns() - t0);
+
+    at25df641_erase_block(AT25DF641_0, PE_ADDR, BLOCK_ERASE_64KB);
+    at25df641_wcb_stats(&before);
+    t0 = at25emu_time_ns();
+
+    for (i = 0; i < APPEND_BYTES; i += APPEND_SIZE)
+    {
+        at25df641_wcb_write(AT25DF641_0, &pattern[i], APPEND_SIZE, PE_ADDR + i);
+    }
+
+    at25df641_wcb_flush();
+    t = at25emu_time_ns() - t0;
+    at25df641_wcb_stats(&after);
+    _rate("wcb_write 32 byte", APPEND_BYTES, t);
+    printf("%-22s %8lu writes %8lu batches %8lu pages\n", "", (unsigned long)(after.writes - before.writes),
+           (unsigned long)(after.batches - before.batches), (unsigned long)(after.pages - before.pages));
+
+    at25df641_read(AT25DF641_0, buf, APPEND_BYTES, PE_ADDR);
+    printf("appended data          %s\n", memcmp(buf, pattern, APPEND_BYTES) ? "DIFFERENT" : "equal");
+}
+
+/**
+ * @brief Brings the work chip to the original and checks it
+ */
+static void _bench_sync(void)
+{
+    at25df641_sync_t stats = {0, 0, 0};
+    uint64_t t0;
+    int ret;
+
+    t0 = at25emu_time_ns();
+    ret = at25df641_verify(AT25DF641_0, AT25DF641_1, 0, AT25DF641_MEM_SIZE, NULL, 0, NULL);
+    printf("verify                 %10.3f ms %d different bytes\n", (at25emu_time_ns() - t0) / 1e6, ret);
+
+    t0 = at25emu_time_ns();
+    ret = at25df641_erase_range(AT25DF641_0, PE_ADDR - 0x3000, 0x13000);
+    printf("erase_range 76KB       %10.3f ms %d erase commands\n", (at25emu_time_ns() - t0) / 1e6, ret);
+
+    t0 = at25emu_time_ns();
+    ret = at25df641_sync(AT25DF641_0, AT25DF641_1, &stats);
+    printf("sync                   %10.3f ms status %d, %lu blocks same, %lu sectors erased, %lu pages written\n",
+           (at25emu_time_ns() - t0) / 1e6, ret, (unsigned long)stats.blocks_same,
+           (unsigned long)stats.sectors_erased, (unsigned long)stats.pages_written);
+
+    t0 = at25emu_time_ns();
+    ret = at25df641_compare_all();
+    printf("compare_all            %10.3f ms %d different bytes\n", (at25emu_time_ns() - t0) / 1e6, ret);
+}
+
+int main(int argc, char **argv)
+{
+    at25emu_timing_t timing = {21000000, 1000, 50000, 250000, 400000, 36000};
+    at25emu_stats_t st;
+    int opt, i;
+
+    while ((opt = getopt(argc, argv, "s:p:e:")) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                timing.spi_hz = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                timing.t_pp_us = strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                timing.t_be4_us = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+
+    if ((argc - optind) != 2)
+    {
+        fprintf(stderr, "usage: %s [-s spi_hz] [-p page_us] [-e erase4k_us] work.img orig.img\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < AT25EMU_CHIPS; i++)
+    {
+        if (at25emu_open(i, argv[optind + i]) != 0)
+        {
+            fprintf(stderr, "can not open %s\n", argv[optind + i]);
+            return 1;
+        }
+    }
+
+    at25emu_set_timing(&timing);
+    spi_init_master(SPI_0, SPI_BAUD_42MHZ_DIV_2);
+
+    if ((at25df641_init(AT25DF641_0) != OK) || (at25df641_init(AT25DF641_1) != OK))
+    {
+        fprintf(stderr, "wrong device id\n");
+        return 1;
+    }
+
+    printf("SPI %u Hz, page %u us, erase 4KB %u us\n\n", timing.spi_hz, timing.t_pp_us, timing.t_be4_us);
+
+    _bench_read("read 0x03", READ_LOW_FREQ);
+    _bench_read("read 0x0B", READ_FAST);
+    _bench_read("read 0x1B", READ_MAX_FREQ);
+    _bench_async();
+    _bench_cache();
+    _bench_pe();
+    _bench_queue();
+    _bench_append();
+
+    _bench_sync();
+
+    printf("\n%-6s %10s %12s %12s %8s %8s %10s\n", "chip", "commands", "read", "programmed", "erases", "suspends", "violations");
+
+    for (i = 0; i < AT25EMU_CHIPS; i++)
+    {
+        at25emu_stats(i, &st);
+        printf("%-6s %10lu %12lu %12lu %8lu %8lu %10lu\n", i ? "orig" : "work",
+               (unsigned long)st.commands, (unsigned long)st.bytes_read,
+               (unsigned long)st.bytes_prog, (unsigned long)st.erases,
+               (unsigned long)st.suspends, (unsigned long)st.violations);
+    }
+
+    at25emu_close();
+
+    return 0;
+}
@@ -0,0 +1,541 @@
+/**
+ * @{
+ *
+ * @brief     Emulation of AT25DF641 chips on a shared SPI bus
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Every chip decodes the opcodes of driver/define/at25df641_def.h byte by
+ * byte between its chip select edges, like the real device. The time is
+ * emulated: each clock on the bus lets it pass, program and erase keep the
+ * chip busy for the time of the timing model. The image changes when an
+ * operation starts, the chip hides this til the operation ends: reads of
+ * a busy chip and of the sector of a suspended operation return 0xFF and
+ * count as violations.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "at25emu.h"
+#include "driver/define/at25df641_def.h"
+
+/** Status register bits of the data sheet */
+#define SR_BUSY         (1 << 0)
+#define SR_WEL          (1 << 1)
+#define SR_SWP_ALL      (3 << 2)
+#define SR_SWP_SOME     (1 << 2)
+#define SR_EPE          (1 << 5)
+
+/** Manufacturer and device id bytes */
+#define ID_BYTES        {0x1F, 0x48, 0x00, 0x00}
+
+/** Number of 64KB sectors which can be protected */
+#define SECTORS         (AT25DF641_MEM_SIZE / AT25DF641_BLOCK_SIZE)
+
+/** Picoseconds per nanosecond */
+#define PS_PER_NS       (1000ULL)
+
+/**
+ * @brief State of one chip
+ */
+typedef struct {
+    uint8_t *mem;               /**< mapped image */
+    int selected;               /**< flag if CS is low */
+    uint8_t cmd;                /**< opcode of the running command */
+    uint32_t pos;               /**< bytes of the running command */
+    uint32_t addr;              /**< address of the running command */
+    uint8_t page[AT25DF641_PAGE_SIZE];  /**< data latched for programming */
+    uint8_t latched[AT25DF641_PAGE_SIZE];/**< flags of the latched bytes */
+    int wel;                    /**< write enable latch */
+    int epe;                    /**< error of the last program/erase */
+    uint8_t prot[SECTORS];      /**< sector protection */
+    uint64_t busy_until;        /**< end of the running operation in ps */
+    uint64_t busy_left;         /**< remaining time of a suspended operation */
+    int suspended;              /**< flag if the operation is suspended */
+    uint32_t busy_addr;         /**< first byte of the sectors of the operation */
+    uint32_t busy_size;         /**< bytes of the sectors of the operation */
+    int hit;                    /**< flag if the read hit the suspended sectors */
+    at25emu_stats_t stats;      /**< counters */
+} chip_t;
+
+static chip_t chips[AT25EMU_CHIPS];
+static uint64_t now_ps;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static at25emu_timing_t timing = {
+    21000000,   /* SPI3 with 42MHz / 2 */
+    1000,       /* tPP 1.0ms */
+    50000,      /* tBLKE 4KB 50ms */
+    250000,     /* tBLKE 32KB 250ms */
+    400000,     /* tBLKE 64KB 400ms */
+    36000,      /* tCHPE 36s */
+};
+
+int at25emu_open(int chip, const char *path)
+{
+    struct stat st;
+    int fd, i, fresh;
+
+    if ((chip < 0) || (chip >= AT25EMU_CHIPS))
+    {
+        return -1;
+    }
+
+    if ((fd = open(path, O_RDWR | O_CREAT, 0644)) < 0)
+    {
+        return -1;
+    }
+
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    fresh = (st.st_size < AT25DF641_MEM_SIZE);
+
+    if (fresh && (ftruncate(fd, AT25DF641_MEM_SIZE) != 0))
+    {
+        close(fd);
+        return -1;
+    }
+
+    chips[chip].mem = mmap(NULL, AT25DF641_MEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (chips[chip].mem == MAP_FAILED)
+    {
+        chips[chip].mem = NULL;
+        return -1;
+    }
+
+    /* erased flash, keeps a shorter image at its start */
+    if (fresh)
+    {
+        memset(&chips[chip].mem[st.st_size], 0xFF, AT25DF641_MEM_SIZE - st.st_size);
+    }
+
+    /* all sectors are protected after power up */
+    for (i = 0; i < SECTORS; i++)
+    {
+        chips[chip].prot[i] = 1;
+    }
+
+    return 0;
+}
+
+void at25emu_close(void)
+{
+    int i;
+
+    for (i = 0; i < AT25EMU_CHIPS; i++)
+    {
+        if (chips[i].mem != NULL)
+        {
+            munmap(chips[i].mem, AT25DF641_MEM_SIZE);
+            chips[i].mem = NULL;
+        }
+    }
+}
+
+void at25emu_set_timing(const at25emu_timing_t *t)
+{
+    pthread_mutex_lock(&lock);
+    timing = *t;
+    pthread_mutex_unlock(&lock);
+}
+
+/**
+ * @brief Checks if a program or erase is running
+ */
+static int _busy(const chip_t *c)
+{
+    return !c->suspended && (c->busy_until > now_ps);
+}
+
+/**
+ * @brief Builds the status register
+ */
+static uint8_t _status(const chip_t *c)
+{
+    int i, prot = 0;
+
+    for (i = 0; i < SECTORS; i++)
+    {
+        prot += c->prot[i];
+    }
+
+    return (_busy(c) ? SR_BUSY : 0) | (c->wel ? SR_WEL : 0) | (c->epe ? SR_EPE : 0) |
+           ((prot == SECTORS) ? SR_SWP_ALL : ((prot > 0) ? SR_SWP_SOME : 0));
+}
+
+/**
+ * @brief Number of dummy bytes of a read command
+ */
+static uint32_t _dummy(uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case AT25DF641_OPCODE_RD_ARRY:
+            return AT25DF641_DUMMY_RD_ARRY;
+        case AT25DF641_OPCODE_RD_ARRY_MAX_FREQ:
+            return AT25DF641_DUMMY_RD_ARRY_MAX_FREQ;
+        case AT25DF641_OPCODE_DUAL_OUT_RD_ARRY:
+            return AT25DF641_DUMMY_DUAL_OUT_RD_ARRY;
+        default:
+            return AT25DF641_DUMMY_RD_ARRY_LOW_FREQ;
+    }
+}
+
+/**
+ * @brief Starts a program or erase operation of the given duration
+ *
+ * @param[in] addr      first changed byte
+ * @param[in] size      number of changed bytes, the whole 64KB sectors of
+ *                      them are undefined while the operation is suspended
+ */
+static void _start_busy(chip_t *c, uint64_t us, uint32_t addr, uint32_t size)
+{
+    c->busy_addr = addr & ~(AT25DF641_BLOCK_SIZE - 1);
+    c->busy_size = ((addr + size + AT25DF641_BLOCK_SIZE - 1) & ~(AT25DF641_BLOCK_SIZE - 1)) - c->busy_addr;
+    c->busy_until = now_ps + us * 1000 * PS_PER_NS;
+    c->suspended = 0;
+    c->wel = 0;
+}
+
+/**
+ * @brief Erases size bytes at the aligned address
+ */
+static void _erase(chip_t *c, uint32_t size, uint64_t us)
+{
+    uint32_t addr = c->addr & ~(size - 1);
+    uint32_t i;
+
+    for (i = addr; i < (addr + size); i += AT25DF641_BLOCK_SIZE)
+    {
+        if (c->prot[i / AT25DF641_BLOCK_SIZE])
+        {
+            c->stats.violations++;
+            c->wel = 0;
+            return;
+        }
+    }
+
+    memset(&c->mem[addr], 0xFF, size);
+    c->stats.erases++;
+    c->epe = 0;
+    _start_busy(c, us, addr, size);
+}
+
+/**
+ * @brief Executes a command at the rising edge of the chip select
+ */
+static void _finish(chip_t *c)
+{
+    uint32_t base = c->addr & ~(AT25DF641_PAGE_SIZE - 1);
+    int i;
+
+    /* only commands which change the array need the write enable */
+    switch (c->cmd)
+    {
+        case AT25DF641_OPCODE_BYTE_PROGR:
+        case AT25DF641_OPCODE_BLOCK_ERASE_4KB:
+        case AT25DF641_OPCODE_BLOCK_ERASE_32KB:
+        case AT25DF641_OPCODE_BLOCK_ERASE_64KB:
+        case AT25DF641_OPCODE_CHIP_ERASE:
+        case AT25DF641_OPCODE_WR_SR_FRST_BYTE:
+        case AT25DF641_OPCODE_PROT_SECT:
+        case AT25DF641_OPCODE_UNPROT_SECT:
+            /* a suspended operation would be lost */
+            if (!c->wel || _busy(c) || c->suspended)
+            {
+                c->stats.violations++;
+                return;
+            }
+            break;
+        default:
+            return;
+    }
+
+    switch (c->cmd)
+    {
+        case AT25DF641_OPCODE_BYTE_PROGR:
+            if ((c->pos < (PACK_SIZ + 1)) || c->prot[c->addr / AT25DF641_BLOCK_SIZE])
+            {
+                c->stats.violations++;
+                c->wel = 0;
+                return;
+            }
+
+            /* programming can only clear bits */
+            for (i = 0; i < AT25DF641_PAGE_SIZE; i++)
+            {
+                if (c->latched[i])
+                {
+                    c->mem[base + i] &= c->page[i];
+                    c->stats.bytes_prog++;
+                }
+            }
+
+            c->epe = 0;
+            _start_busy(c, timing.t_pp_us, base, AT25DF641_PAGE_SIZE);
+            break;
+
+        case AT25DF641_OPCODE_BLOCK_ERASE_4KB:
+            _erase(c, 4 * 1024, timing.t_be4_us);
+            break;
+
+        case AT25DF641_OPCODE_BLOCK_ERASE_32KB:
+            _erase(c, 32 * 1024, timing.t_be32_us);
+            break;
+
+        case AT25DF641_OPCODE_BLOCK_ERASE_64KB:
+            _erase(c, AT25DF641_BLOCK_SIZE, timing.t_be64_us);
+            break;
+
+        case AT25DF641_OPCODE_CHIP_ERASE:
+            c->addr = 0;
+            _erase(c, AT25DF641_MEM_SIZE, (uint64_t)timing.t_ce_ms * 1000);
+            break;
+
+        case AT25DF641_OPCODE_WR_SR_FRST_BYTE:
+            /* global protect and unprotect, other values keep the sectors */
+            if (c->pos >= 2)
+            {
+                if ((c->page[0] & AT25DF641_GLOBAL_PROTECT_VALUE) == AT25DF641_GLOBAL_PROTECT_VALUE)
+                {
+                    memset(c->prot, 1, SECTORS);
+                }
+                else if ((c->page[0] & AT25DF641_GLOBAL_PROTECT_VALUE) == 0)
+                {
+                    memset(c->prot, 0, SECTORS);
+                }
+            }
+            c->wel = 0;
+            break;
+
+        case AT25DF641_OPCODE_PROT_SECT:
+        case AT25DF641_OPCODE_UNPROT_SECT:
+            if (c->pos >= PACK_SIZ)
+            {
+                c->prot[c->addr / AT25DF641_BLOCK_SIZE] = (c->cmd == AT25DF641_OPCODE_PROT_SECT);
+            }
+            c->wel = 0;
+            break;
+    }
+}
+
+/**
+ * @brief Feeds one byte to a selected chip and returns its answer
+ */
+static uint8_t _clock_byte(chip_t *c, uint8_t in)
+{
+    static const uint8_t id[] = ID_BYTES;
+    uint32_t n = c->pos++;
+
+    if (n == 0)
+    {
+        c->cmd = in;
+        c->addr = 0;
+        c->hit = 0;
+        memset(c->latched, 0, sizeof c->latched);
+
+        /* commands which execute with the opcode */
+        switch (in)
+        {
+            case AT25DF641_OPCODE_WR_EN:
+                c->wel = !_busy(c) && !c->suspended;
+                break;
+            case AT25DF641_OPCODE_WR_DIS:
+                c->wel = 0;
+                break;
+            case AT25DF641_OPCODE_PROGR_SUSP:
+                if (_busy(c))
+                {
+                    c->busy_left = c->busy_until - now_ps;
+                    c->suspended = 1;
+                    c->stats.suspends++;
+                }
+                break;
+            case AT25DF641_OPCODE_PROGR_RESUM:
+                if (c->suspended)
+                {
+                    c->busy_until = now_ps + c->busy_left;
+                    c->suspended = 0;
+                }
+                break;
+        }
+
+        return 0xFF;
+    }
+
+    /* address bytes, the chip ignores the bits above its size */
+    if (n < PACK_SIZ)
+    {
+        c->addr = ((c->addr << 8) | in) & (AT25DF641_MEM_SIZE - 1);
+
+        if (c->cmd == AT25DF641_OPCODE_WR_SR_FRST_BYTE)
+        {
+            c->page[0] = in;
+        }
+    }
+
+    switch (c->cmd)
+    {
+        case AT25DF641_OPCODE_RD_SR:
+            return _status(c);
+
+        case AT25DF641_OPCODE_RD_ID:
+            return ((n - 1) < sizeof id) ? id[n - 1] : 0x00;
+
+        case AT25DF641_OPCODE_RD_SECT_PROT_REG:
+            return (n >= PACK_SIZ) ? (c->prot[(c->addr / AT25DF641_BLOCK_SIZE) % SECTORS] ? 0xFF : 0x00) : 0xFF;
+
+        case AT25DF641_OPCODE_RD_ARRY:
+        case AT25DF641_OPCODE_RD_ARRY_MAX_FREQ:
+        case AT25DF641_OPCODE_RD_ARRY_LOW_FREQ:
+        case AT25DF641_OPCODE_DUAL_OUT_RD_ARRY:
+        {
+            uint32_t addr;
+
+            if (n < (PACK_SIZ + _dummy(c->cmd)))
+            {
+                return 0xFF;
+            }
+
+            /* the array can not be read while programming */
+            if (_busy(c))
+            {
+                if (n == (PACK_SIZ + _dummy(c->cmd)))
+                {
+                    c->stats.violations++;
+                }
+                return 0xFF;
+            }
+
+            addr = (c->addr + (n - PACK_SIZ - _dummy(c->cmd))) % AT25DF641_MEM_SIZE;
+
+            /* the sectors of a suspended operation have no valid data */
+            if (c->suspended && (addr >= c->busy_addr) && (addr < (c->busy_addr + c->busy_size)))
+            {
+                if (!c->hit)
+                {
+                    c->stats.violations++;
+                    c->hit = 1;
+                }
+                return 0xFF;
+            }
+
+            c->stats.bytes_read++;
+            return c->mem[addr];
+        }
+
+        case AT25DF641_OPCODE_BYTE_PROGR:
+            /* bytes behind the end of the page wrap to its start */
+            if (n >= PACK_SIZ)
+            {
+                uint32_t i = (c->addr + (n - PACK_SIZ)) % AT25DF641_PAGE_SIZE;
+                c->page[i] = in;
+                c->latched[i] = 1;
+            }
+            return 0xFF;
+
+        default:
+            return 0xFF;
+    }
+}
+
+void at25emu_select(int chip, int selected)
+{
+    chip_t *c = &chips[chip];
+
+    pthread_mutex_lock(&lock);
+
+    if (selected && !c->selected)
+    {
+        c->pos = 0;
+        c->stats.commands++;
+    }
+    else if (!selected && c->selected && (c->pos > 0))
+    {
+        _finish(c);
+    }
+
+    c->selected = selected;
+
+    pthread_mutex_unlock(&lock);
+}
+
+/**
+ * @brief Clocks a byte through all selected chips
+ *
+ * @param[in] ps        time of the byte on the bus
+ */
+static uint8_t _transfer(uint8_t out, uint64_t ps)
+{
+    uint8_t in = 0xFF;
+    int i;
+
+    now_ps += ps;
+
+    for (i = 0; i < AT25EMU_CHIPS; i++)
+    {
+        if (chips[i].selected && (chips[i].mem != NULL))
+        {
+            /* more than one selected chip fight on the bus */
+            in &= _clock_byte(&chips[i], out);
+        }
+    }
+
+    return in;
+}
+
+uint8_t at25emu_transfer(uint8_t out)
+{
+    uint8_t in;
+
+    pthread_mutex_lock(&lock);
+    in = _transfer(out, (8ULL * 1000000000ULL * PS_PER_NS) / timing.spi_hz);
+    pthread_mutex_unlock(&lock);
+
+    return in;
+}
+
+uint64_t at25emu_time_ns(void)
+{
+    uint64_t ns;
+
+    pthread_mutex_lock(&lock);
+    ns = now_ps / PS_PER_NS;
+    pthread_mutex_unlock(&lock);
+
+    return ns;
+}
+
+void at25emu_idle_until(uint64_t ns)
+{
+    pthread_mutex_lock(&lock);
+
+    if ((ns * PS_PER_NS) > now_ps)
+    {
+        now_ps = ns * PS_PER_NS;
+    }
+
+    pthread_mutex_unlock(&lock);
+}
+
+void at25emu_stats(int chip, at25emu_stats_t *stats)
+{
+    pthread_mutex_lock(&lock);
+    *stats = chips[chip].stats;
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,97 @@
+/**
+ * @{
+ *
+ * @brief     Emulation of AT25DF641 chips on a shared SPI bus
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#ifndef AT25EMU_H
+#define AT25EMU_H
+
+#include <stdint.h>
+
+/** Number of emulated chips, in order of at25df641_dev_t */
+#define AT25EMU_CHIPS       (2)
+
+/**
+ * @brief Timing model, all times are typical values of the data sheet
+ */
+typedef struct {
+    uint32_t spi_hz;        /**< SPI clock */
+    uint32_t t_pp_us;       /**< page program time */
+    uint32_t t_be4_us;      /**< 4KB block erase time */
+    uint32_t t_be32_us;     /**< 32KB block erase time */
+    uint32_t t_be64_us;     /**< 64KB block erase time */
+    uint32_t t_ce_ms;       /**< chip erase time */
+} at25emu_timing_t;
+
+/**
+ * @brief Counters of one chip
+ */
+typedef struct {
+    uint64_t commands;      /**< number of commands (chip selects) */
+    uint64_t bytes_read;    /**< bytes read from the array */
+    uint64_t bytes_prog;    /**< bytes programmed */
+    uint64_t erases;        /**< erase commands */
+    uint64_t suspends;      /**< suspended program/erase operations */
+    uint64_t violations;    /**< commands ignored as busy, suspended, protected or
+                                 not enabled, reads of a suspended sector */
+} at25emu_stats_t;
+
+/**
+ * @brief Maps an image file as memory of a chip
+ *
+ * A missing or short file is created and filled with 0xFF like erased
+ * flash. Changes are written to the file.
+ *
+ * @param[in] chip      number of the chip
+ * @param[in] *path     image file
+ *
+ * @return              0 on success, -1 on error
+ */
+int at25emu_open(int chip, const char *path);
+
+/**
+ * @brief Unmaps all images
+ */
+void at25emu_close(void);
+
+/**
+ * @brief Sets the timing model, defaults are the AT25DF641 values at 21MHz
+ */
+void at25emu_set_timing(const at25emu_timing_t *timing);
+
+/**
+ * @brief Drives the chip select of a chip
+ *
+ * @param[in] chip      number of the chip
+ * @param[in] selected  1 for CS low, 0 for CS high
+ */
+void at25emu_select(int chip, int selected);
+
+/**
+ * @brief Transfers one byte on the bus, 8 clocks
+ */
+uint8_t at25emu_transfer(uint8_t out);
+
+/**
+ * @brief Returns the emulated time in ns
+ */
+uint64_t at25emu_time_ns(void);
+
+/**
+ * @brief Lets the emulated time pass til the given time
+ *
+ * Used while the bus is idle, the time never goes back.
+ */
+void at25emu_idle_until(uint64_t ns);
+
+/**
+ * @brief Returns the counters of a chip
+ */
+void at25emu_stats(int chip, at25emu_stats_t *stats);
+
+#endif /* AT25EMU_H */
@@ -0,0 +1,149 @@
+/**
+ * @{
+ *
+ * @brief     Runs the serial upload against the emulated chips and a pty
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Build from the root of the repository:
+ *
+ *   gcc -O2 -pthread -Itools/at25emu -I. -o at25ingest tools/at25emu/at25emu.c \
+ *       tools/at25emu/host.c tools/at25emu/at25ingest.c ingest.c at25df641.c
+ *
+ * Usage: at25ingest [-s spi_hz] [-r read_bytes] work.img orig.img
+ *
+ * Prints the pseudo terminal of the UART and serves uploads from
+ * tools/upload like the firmware, while a playback of read_bytes per MP3
+ * frame (default 1044, 320 kbit/s) reads the orig chip. Reports the rate
+ * of every upload and the longest playback read. Ends after a commit.
+ * All times are emulated times.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "at25emu.h"
+#include "include/ingest.h"
+#include "driver/at25df641.h"
+#include "driver/spi.h"
+#include "driver/define/at25df641_def.h"
+
+/** Period of the flash tick in ns */
+#define TICK_NS         (1000000ULL)
+/** Period of the playback reads, one MP3 frame at 44.1kHz */
+#define FRAME_NS        (26122449ULL)
+/** Range of the orig chip the playback reads from */
+#define PLAY_RANGE      (4 * 1024 * 1024)
+
+static unsigned char buf[4096];
+
+int main(int argc, char **argv)
+{
+    at25emu_timing_t timing = {21000000, 1000, 50000, 250000, 400000, 36000};
+    uint64_t now, next_tick = 0, next_frame = 0, start = 0, t, worst = 0;
+    uint32_t play_addr = 0, frames = 0;
+    int read_bytes = 1044;
+    int opt, i, busy = 0;
+
+    while ((opt = getopt(argc, argv, "s:r:")) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                timing.spi_hz = strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                read_bytes = atoi(optarg);
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+
+    if (((argc - optind) != 2) || (read_bytes < 0) || (read_bytes > (int)sizeof buf))
+    {
+        fprintf(stderr, "usage: %s [-s spi_hz] [-r read_bytes] work.img orig.img\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < AT25EMU_CHIPS; i++)
+    {
+        if (at25emu_open(i, argv[optind + i]) != 0)
+        {
+            fprintf(stderr, "can not open %s\n", argv[optind + i]);
+            return 1;
+        }
+    }
+
+    at25emu_set_timing(&timing);
+    spi_init_master(SPI_0, SPI_BAUD_42MHZ_DIV_2);
+
+    if ((at25df641_init(AT25DF641_0) != OK) || (at25df641_init(AT25DF641_1) != OK) ||
+        (ingest_init() != OK))
+    {
+        fprintf(stderr, "init failed\n");
+        return 1;
+    }
+
+    for (;;)
+    {
+        now = at25emu_time_ns();
+
+        /* the 1ms timer interrupt, missed ticks are served with one call */
+        if (now >= next_tick)
+        {
+            at25df641_tick();
+            next_tick = now - (now % TICK_NS) + TICK_NS;
+        }
+
+        /* the playback reads the orig chip in the meantime */
+        if ((now >= next_frame) && (read_bytes > 0))
+        {
+            t = at25emu_time_ns();
+            at25df641_read(AT25DF641_1, buf, read_bytes, play_addr);
+            t = at25emu_time_ns() - t;
+            worst = (t > worst) ? t : worst;
+            frames++;
+            play_addr = (play_addr + read_bytes) % PLAY_RANGE;
+            next_frame += FRAME_NS;
+        }
+
+        switch (ingest_poll())
+        {
+            case INGEST_EV_WRITE:
+                printf("write started\n");
+                start = at25emu_time_ns();
+                worst = 0;
+                frames = 0;
+                busy = 1;
+                break;
+            case INGEST_EV_COMMIT:
+                t = at25emu_time_ns();
+                i = ingest_commit();
+                printf("commit: %d, %.3f s\n", i, (at25emu_time_ns() - t) / 1e9);
+                at25emu_close();
+                return (i == OK) ? 0 : 1;
+            default:
+                break;
+        }
+
+        if (busy && !ingest_busy())
+        {
+            t = at25emu_time_ns() - start;
+            printf("write done: %.3f s, %u playback reads, longest %.3f ms\n", t / 1e9, frames,
+                   worst / 1e6);
+            busy = 0;
+        }
+
+        /* nothing to do til the next tick or frame */
+        now = at25emu_time_ns();
+        t = (next_tick < next_frame) ? next_tick : next_frame;
+        at25emu_idle_until((t > now) ? t : now);
+    }
+}
@@ -0,0 +1,220 @@
+/**
+ * @{
+ *
+ * @brief     Runs the jitter buffer of the live stream against a pty
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Build from the root of the repository:
+ *
+ *   gcc -O2 -pthread -Itools/at25emu -I. -o at25stream tools/at25emu/at25emu.c \
+ *       tools/at25emu/host.c tools/at25emu/at25stream.c stream.c inbuf.c prof.c
+ *
+ * Usage: at25stream
+ *
+ * Prints the pseudo terminal of the stream UART and plays the stream from
+ * tools/mp3send like the firmware: the output takes one frame per frame
+ * duration from the jitter buffer, parsed from the headers instead of
+ * decoded. Prints the fill level every second and the counters at the end
+ * of the stream, with the host time of the input stage per frame
+ * (include/prof.h): the wait for the jitter buffer and the sync search.
+ * There is no decoder on the host, the other stages are only measured on
+ * the board. Unlike the other tools it runs in real time, the sender paces
+ * the stream with the clock of the host.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "at25emu.h"
+#include "include/stream.h"
+#include "include/inbuf.h"
+#include "include/prof.h"
+#include "driver/define/at25df641_def.h"
+
+/** Largest block the decoder takes at once (MAINBUF_SIZE) */
+#define DECODER_BLOCK   (1940)
+/** Period of the stream tick in ns */
+#define TICK_NS         (1000000ULL)
+
+/** Bitrates in kbit/s of layer 3, MPEG-1 and MPEG-2/2.5 */
+static const int bitrate_tab[2][16] = {
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}
+};
+
+/** Sample rates in Hz of MPEG-1 */
+static const int samplerate_tab[4] = {44100, 48000, 32000, 0};
+
+static inbuf_t mem;
+
+/**
+ * @brief Parses a layer 3 frame header like the decoder
+ *
+ * @return size of the frame, 0 if p holds no valid header
+ */
+static int _parse_header(const unsigned char *p, int *bitrate)
+{
+    int version, index, rate, mpeg1;
+
+    if ((p[0] != 0xFF) || ((p[1] & 0xE0) != 0xE0))
+    {
+        return 0;
+    }
+
+    version = (p[1] >> 3) & 0x03;
+    index = (p[2] >> 4) & 0x0F;
+    rate = (p[2] >> 2) & 0x03;
+
+    if ((version == 1) || (((p[1] >> 1) & 0x03) != 1) || (index == 0) || (index == 15) ||
+        (rate == 3))
+    {
+        return 0;
+    }
+
+    mpeg1 = (version == 3);
+    rate = samplerate_tab[rate] >> (mpeg1 ? 0 : ((version == 2) ? 1 : 2));
+    *bitrate = 1000 * bitrate_tab[mpeg1 ? 0 : 1][index];
+
+    return ((mpeg1 ? 144 : 72) * *bitrate) / rate + ((p[2] >> 1) & 0x01);
+}
+
+static uint64_t _now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+/**
+ * @brief Takes one frame out of the buffer, like MP3FindSyncWord and MP3Decode
+ *
+ * @return              1 if a frame was taken
+ */
+static int _take_frame(int *bitrate)
+{
+    unsigned char *ptr;
+    int len, size, i;
+
+    ptr = inbuf_read_ptr(&mem, &len);
+
+    for (i = 0; (i + 4) <= len; i++)
+    {
+        if ((size = _parse_header(&ptr[i], bitrate)) > 0)
+        {
+            break;
+        }
+    }
+
+    if ((i + 4) > len)
+    {
+        inbuf_consume(&mem, len);
+        return 0;
+    }
+
+    inbuf_consume(&mem, MINIMUM(i + size, len));
+
+    return 1;
+}
+
+int main(void)
+{
+    stream_stats_t stats;
+    prof_stats_t input;
+    uint64_t start, now, mark, ticks = 0, next_frame = 0, next_report = 0;
+    uint64_t frame_ns = 1152ULL * 1000000000ULL / 44100;
+    uint32_t frames = 0;
+    int bitrate = 0;
+    int running = 0;
+
+    if (stream_init() != OK)
+    {
+        fprintf(stderr, "init failed\n");
+        return 1;
+    }
+
+    start = _now();
+
+    for (;;)
+    {
+        /* the emulated time follows the host */
+        now = _now() - start;
+        at25emu_idle_until(now);
+
+        while ((ticks * TICK_NS) < now)
+        {
+            stream_tick();
+            ticks++;
+        }
+
+        switch (stream_poll())
+        {
+            case STREAM_EV_START:
+                printf("stream started\n");
+                stream_start(&mem);
+                prof_reset();
+                next_frame = now;
+                next_report = now + 1000000000ULL;
+                frames = 0;
+                running = 1;
+                break;
+            case STREAM_EV_END:
+                stream_stats(&stats);
+                printf("end of stream: %u frames, %u bytes, target %u ms, %u underruns, "
+                       "%u overruns, %u dropped\n", frames, stats.received, stats.target_ms,
+                       stats.underruns, stats.overruns, stats.dropped);
+                prof_get(PROF_INPUT, &input);
+                printf("input stage of %u frames in us (min / avg / max): %u / %u / %u\n",
+                       input.frames, input.min / 1000, input.avg / 1000, input.max / 1000);
+                return 0;
+            default:
+                break;
+        }
+
+        if (running && (now >= next_frame))
+        {
+            mark = _now();
+
+            if (stream_ready(DECODER_BLOCK))
+            {
+                if (_take_frame(&bitrate))
+                {
+                    prof_add(PROF_INPUT, (uint32_t)(_now() - mark));
+                    prof_frame();
+                    stream_set_bitrate(bitrate);
+                    frames++;
+
+                    /* a dropped frame takes no output time */
+                    if (!stream_skip())
+                    {
+                        next_frame += frame_ns;
+                    }
+                }
+            }
+            else
+            {
+                /* the output runs dry til the buffer is filled again */
+                next_frame = now;
+            }
+        }
+
+        if (running && (now >= next_report))
+        {
+            stream_stats(&stats);
+            printf("%5.1f s: fill %4u ms, target %4u ms, %u underruns, %u overruns, %u dropped\n",
+                   now / 1e9, stats.fill_ms, stats.target_ms, stats.underruns,
+                   stats.overruns, stats.dropped);
+            fflush(stdout);
+            next_report += 1000000000ULL;
+        }
+
+        usleep(200);
+    }
+}
@@ -0,0 +1,436 @@
+/**
+ * @{
+ *
+ * @brief     Host versions of the GPIO, SPI, UART and CRC drivers for the emulator
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * The chip select pins of both flash chips drive the emulated chips, the
+ * SPI transfers clock their bytes. DMA transfers run in a worker thread
+ * which calls the callback like the DMA interrupt. The UART is a pseudo
+ * terminal, its receive DMA delivers the bytes at the baudrate in the
+ * emulated time.
+ *
+ * @}
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <pthread.h>
+#include <stm32f4xx.h>
+
+#include "at25emu.h"
+#include "driver/gpio.h"
+#include "driver/spi.h"
+#include "driver/crc.h"
+#include "driver/uart.h"
+#include "driver/config/periph_conf.h"
+
+GPIO_TypeDef host_gpio[9];
+
+/**
+ * @brief Running DMA transfer
+ */
+static struct {
+    const unsigned char *out;
+    unsigned char *in;
+    uint16_t len;
+    spi_cb_t cb;
+    void *arg;
+    int busy;
+} dma;
+
+static pthread_mutex_t dma_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dma_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t dma_thread;
+static int dma_started;
+
+static volatile int bus_locked;
+
+static uint32_t crc_value;
+
+/**
+ * @brief UART stand-in, one pseudo terminal per device
+ */
+static struct {
+    int fd;                 /**< master side of the pseudo terminal */
+    uint64_t byte_ns;       /**< time of one byte with start and stop bit */
+    uint64_t next_ns;       /**< end of the last received byte */
+    unsigned char *buf;     /**< receive ring */
+    uint16_t len;           /**< size of the ring */
+    uint16_t pos;           /**< next position of the DMA */
+} uart[UART_NUMOF] = {{.fd = -1}, {.fd = -1}};
+
+/**
+ * @brief Returns the emulated chip of a chip select pin, -1 for others
+ */
+static int _chip(GPIO_TypeDef *port, gpio_t pin)
+{
+    if ((port == WORK_CS_PORT) && (pin == WORK_CS_PIN))
+    {
+        return 0;
+    }
+
+    if ((port == ORIG_CS_PORT) && (pin == ORIG_CS_PIN))
+    {
+        return 1;
+    }
+
+    return -1;
+}
+
+int gpio_init(gpio_dir_t dir, GPIO_TypeDef *port, gpio_t pin)
+{
+    port->MODER = (port->MODER & ~(3u << (2 * pin))) | ((uint32_t)dir << (2 * pin));
+    return 0;
+}
+
+int gpio_read(GPIO_TypeDef *port, gpio_t pin)
+{
+    return (port->ODR >> pin) & 1;
+}
+
+void gpio_set(GPIO_TypeDef *port, gpio_t pin)
+{
+    int chip = _chip(port, pin);
+
+    port->ODR |= (1u << pin);
+
+    if (chip >= 0)
+    {
+        at25emu_select(chip, 0);
+    }
+}
+
+void gpio_clear(GPIO_TypeDef *port, gpio_t pin)
+{
+    int chip = _chip(port, pin);
+
+    port->ODR &= ~(1u << pin);
+
+    if (chip >= 0)
+    {
+        at25emu_select(chip, 1);
+    }
+}
+
+void gpio_toggle(GPIO_TypeDef *port, gpio_t pin)
+{
+    gpio_write(port, pin, !gpio_read(port, pin));
+}
+
+void gpio_write(GPIO_TypeDef *port, gpio_t pin, int value)
+{
+    if (value)
+    {
+        gpio_set(port, pin);
+    }
+    else
+    {
+        gpio_clear(port, pin);
+    }
+}
+
+/**
+ * @brief Plays the DMA and its interrupt
+ */
+static void *_dma_worker(void *unused)
+{
+    spi_cb_t cb;
+    void *arg;
+    int i;
+
+    (void)unused;
+
+    pthread_mutex_lock(&dma_lock);
+
+    for (;;)
+    {
+        while (dma.busy != 1)
+        {
+            pthread_cond_wait(&dma_cond, &dma_lock);
+        }
+
+        pthread_mutex_unlock(&dma_lock);
+
+        for (i = 0; i < dma.len; i++)
+        {
+            unsigned char in = at25emu_transfer(dma.out ? dma.out[i] : 0xFF);
+
+            if (dma.in != NULL)
+            {
+                dma.in[i] = in;
+            }
+        }
+
+        pthread_mutex_lock(&dma_lock);
+        cb = dma.cb;
+        arg = dma.arg;
+        dma.busy = 0;
+
+        /* the callback may start the next transfer */
+        if (cb != NULL)
+        {
+            pthread_mutex_unlock(&dma_lock);
+            cb(arg, 0);
+            pthread_mutex_lock(&dma_lock);
+        }
+    }
+
+    return NULL;
+}
+
+int spi_init_master(spi_t dev, spi_baud_t baud)
+{
+    (void)dev;
+    (void)baud;
+
+    if (!dma_started)
+    {
+        dma_started = 1;
+        pthread_create(&dma_thread, NULL, _dma_worker, NULL);
+    }
+
+    return 0;
+}
+
+int spi_conf_pins(spi_t dev)
+{
+    (void)dev;
+    return 0;
+}
+
+void spi_transfer_byte(spi_t dev, unsigned char out, unsigned char *in)
+{
+    unsigned char tmp = at25emu_transfer(out);
+
+    (void)dev;
+
+    if (in != NULL)
+    {
+        *in = tmp;
+    }
+}
+
+int spi_transfer_buf(spi_t dev, const unsigned char *out, unsigned char *in,
+                     int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        spi_transfer_byte(dev, out ? out[i] : 0xFF, in ? &in[i] : NULL);
+    }
+
+    return 0;
+}
+
+int spi_transfer_dma(spi_t dev, const unsigned char *out, unsigned char *in,
+                     uint16_t len, spi_cb_t cb, void *arg)
+{
+    (void)dev;
+
+    if (len == 0)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&dma_lock);
+
+    if (dma.busy)
+    {
+        pthread_mutex_unlock(&dma_lock);
+        return -1;
+    }
+
+    dma.out = out;
+    dma.in = in;
+    dma.len = len;
+    dma.cb = cb;
+    dma.arg = arg;
+    dma.busy = 1;
+
+    pthread_cond_signal(&dma_cond);
+    pthread_mutex_unlock(&dma_lock);
+
+    return 0;
+}
+
+int spi_acquire(spi_t dev)
+{
+    (void)dev;
+    return __sync_lock_test_and_set(&bus_locked, 1) ? -1 : 0;
+}
+
+int spi_release(spi_t dev)
+{
+    (void)dev;
+    __sync_lock_release(&bus_locked);
+    return 0;
+}
+
+void spi_poweron(spi_t dev)
+{
+    (void)dev;
+}
+
+void spi_poweroff(spi_t dev)
+{
+    (void)dev;
+}
+
+void crc_init(void)
+{
+    crc_value = 0xFFFFFFFF;
+}
+
+/**
+ * @brief Feeds one word like the CRC unit, MSB first with poly 0x04C11DB7
+ */
+static void _crc_word(uint32_t word)
+{
+    int i;
+
+    crc_value ^= word;
+
+    for (i = 0; i < 32; i++)
+    {
+        crc_value = (crc_value & 0x80000000) ? ((crc_value << 1) ^ 0x04C11DB7) : (crc_value << 1);
+    }
+}
+
+uint32_t crc_update(const void *data, uint32_t len)
+{
+    const uint8_t *ptr = data;
+    uint32_t word;
+
+    while (len >= 4)
+    {
+        _crc_word(ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((uint32_t)ptr[3] << 24));
+        ptr += 4;
+        len -= 4;
+    }
+
+    /* the tail is padded with zeros to a word */
+    if (len > 0)
+    {
+        word = 0;
+
+        while (len-- > 0)
+        {
+            word |= (uint32_t)ptr[len] << (8 * len);
+        }
+
+        _crc_word(word);
+    }
+
+    return crc_value;
+}
+
+uint32_t crc_calc(const void *data, uint32_t len)
+{
+    crc_init();
+    return crc_update(data, len);
+}
+
+int uart_init(uart_t dev, uint32_t baud)
+{
+    struct termios tio;
+
+    if (uart[dev].fd < 0)
+    {
+        if (((uart[dev].fd = posix_openpt(O_RDWR | O_NOCTTY)) < 0) ||
+            (grantpt(uart[dev].fd) != 0) || (unlockpt(uart[dev].fd) != 0))
+        {
+            return -1;
+        }
+
+        /* raw bytes, the host tool opens the slave side */
+        tcgetattr(uart[dev].fd, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(uart[dev].fd, TCSANOW, &tio);
+        fcntl(uart[dev].fd, F_SETFL, O_NONBLOCK);
+        printf("uart%d: %s\n", dev, ptsname(uart[dev].fd));
+        fflush(stdout);
+    }
+
+    uart[dev].byte_ns = 10000000000ULL / baud;
+
+    return 0;
+}
+
+void uart_write(uart_t dev, const unsigned char *data, int len)
+{
+    ssize_t n;
+
+    while (len > 0)
+    {
+        if ((n = write(uart[dev].fd, data, len)) > 0)
+        {
+            data += n;
+            len -= (int)n;
+        }
+        else
+        {
+            usleep(100);
+        }
+    }
+}
+
+int uart_rx_start(uart_t dev, unsigned char *buf, uint16_t len)
+{
+    uart[dev].buf = buf;
+    uart[dev].len = len;
+    uart[dev].pos = 0;
+    uart[dev].next_ns = at25emu_time_ns();
+
+    return 0;
+}
+
+uint16_t uart_rx_pos(uart_t dev)
+{
+    unsigned char tmp[4096];
+    uint64_t now = at25emu_time_ns();
+    uint64_t n;
+    ssize_t got;
+    int i;
+
+    if ((uart[dev].buf == NULL) || ((uart[dev].next_ns + uart[dev].byte_ns) > now))
+    {
+        return uart[dev].pos;
+    }
+
+    /* the bytes which fit into the time since the last one */
+    n = (now - uart[dev].next_ns) / uart[dev].byte_ns;
+    n = (n < sizeof tmp) ? n : sizeof tmp;
+
+    if ((got = read(uart[dev].fd, tmp, n)) <= 0)
+    {
+        /* idle line, give the sender some real time */
+        uart[dev].next_ns = now;
+        usleep(100);
+        return uart[dev].pos;
+    }
+
+    for (i = 0; i < got; i++)
+    {
+        uart[dev].buf[uart[dev].pos] = tmp[i];
+        uart[dev].pos = (uart[dev].pos + 1) % uart[dev].len;
+    }
+
+    uart[dev].next_ns = ((uint64_t)got < n) ? now : (uart[dev].next_ns + got * uart[dev].byte_ns);
+
+    return uart[dev].pos;
+}
+
+void uart_rx_stop(uart_t dev)
+{
+    uart[dev].buf = NULL;
+}
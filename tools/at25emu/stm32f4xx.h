@@ -0,0 +1,51 @@
+/**
+ * @{
+ *
+ * @brief     Host stand-in for the device header, used by the emulator
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Only provides what the flash driver needs to compile on the host. The
+ * ports are plain memory, the chip selects are decoded in host.c.
+ *
+ * @}
+ */
+
+#ifndef STM32F4XX_H
+#define STM32F4XX_H
+
+#include <stdint.h>
+
+#define __IO volatile
+
+typedef struct {
+    __IO uint32_t MODER;
+    __IO uint32_t OTYPER;
+    __IO uint32_t OSPEEDR;
+    __IO uint32_t PUPDR;
+    __IO uint32_t IDR;
+    __IO uint32_t ODR;
+    __IO uint32_t BSRR;
+    __IO uint32_t LCKR;
+    __IO uint32_t AFR[2];
+} GPIO_TypeDef;
+
+/** Memory of the ports A - I */
+extern GPIO_TypeDef host_gpio[9];
+
+#define GPIOA   (&host_gpio[0])
+#define GPIOB   (&host_gpio[1])
+#define GPIOC   (&host_gpio[2])
+#define GPIOD   (&host_gpio[3])
+#define GPIOE   (&host_gpio[4])
+#define GPIOF   (&host_gpio[5])
+#define GPIOG   (&host_gpio[6])
+#define GPIOH   (&host_gpio[7])
+#define GPIOI   (&host_gpio[8])
+
+/* the host runs without interrupts */
+#define __get_PRIMASK()     (0u)
+#define __set_PRIMASK(x)    ((void)(x))
+#define __disable_irq()     ((void)0)
+
+#endif /* STM32F4XX_H */
@@ -0,0 +1,661 @@
+/**
+ * @{
+ *
+ * @brief     Host tool which packs MP3 and WAV files into an AT25DF641 flash image
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Build on a little endian Linux host, from the repository root:
+ *   gcc -O2 -pthread -I. -o mkflash tools/mkflash/mkflash.c trackdir.c
+ *
+ * Usage:
+ *   mkflash [-j threads] -o image.bin track1.mp3 [track2.wav ...]
+ *
+ * ID3v2 and ID3v1 tags and junk around the frames are stripped. Every track
+ * starts at a 4KB sector with its first frame and is followed by its seek
+ * index. WAV files with 16 bit PCM or IMA-ADPCM are stored with a minimal
+ * header in front of the samples and without index. The directory is written to TRACKDIR_ADDR, unused memory is 0xFF
+ * like erased flash. The files are parsed in parallel, the layout follows
+ * the order of the arguments, so the image is the same for any thread count.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "include/trackdir.h"
+#include "driver/define/at25df641_def.h"
+
+/** Alignment of the tracks, smallest erasable block */
+#define TRACK_ALIGN     (4 * 1024)
+/** Alignment of the seek index */
+#define INDEX_ALIGN     (16)
+/** Number of frames which have to follow each other to accept a sync */
+#define SYNC_FRAMES     (3)
+/** Largest fmt chunk taken over from a WAV file */
+#define WAV_FMT_MAX     (40)
+/** Size of the header which is stored in front of the WAV samples */
+#define WAV_HEADER_MAX  (12 + 8 + WAV_FMT_MAX + 8)
+
+/** Rounds up to a multiple of a power of two */
+#define ALIGN_UP(x, a)  (((x) + (a) - 1) & ~((uint32_t)(a) - 1))
+
+/**
+ * @brief Parsed layer 3 frame header
+ */
+typedef struct {
+    int size;           /**< size of the frame in bytes */
+    int samplerate;     /**< sample rate in Hz */
+    int channels;       /**< number of channels */
+    int samples;        /**< samples per channel of the frame */
+} frame_t;
+
+/**
+ * @brief One input file and the result of its parsing
+ */
+typedef struct {
+    const char *path;       /**< path of the file */
+    unsigned char *data;    /**< content of the file */
+    uint32_t start;         /**< offset of the first frame in data */
+    uint32_t length;        /**< bytes of all frames */
+    uint32_t frames;        /**< number of frames */
+    uint16_t *sizes;        /**< size of every frame */
+    frame_t first;          /**< header of the first frame */
+    int format;             /**< encoding, TRACKDIR_FMT_x */
+    unsigned char wav[WAV_HEADER_MAX]; /**< header stored in front of WAV samples */
+    uint32_t wav_size;      /**< size of the WAV header */
+    int status;             /**< 0 on success */
+} track_t;
+
+/** Work queue of the parser threads */
+static track_t *tracks;
+static int track_count;
+static int next_track;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Tracks marked for the PCM cache, bit 0 is the first track */
+static uint32_t pcm_tracks;
+
+/** Bitrates in kbit/s of layer 3, MPEG-1 and MPEG-2/2.5 */
+static const int bitrate_tab[2][16] = {
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}
+};
+
+/** Sample rates in Hz of MPEG-1 */
+static const int samplerate_tab[4] = {44100, 48000, 32000, 0};
+
+/**
+ * @brief Parses a layer 3 frame header
+ *
+ * @return 0 if p holds a valid header, -1 otherwise
+ */
+static int _parse_header(const unsigned char *p, frame_t *frame)
+{
+    int version, bitrate, rate, padding, mpeg1;
+
+    if ((p[0] != 0xFF) || ((p[1] & 0xE0) != 0xE0))
+    {
+        return -1;
+    }
+
+    version = (p[1] >> 3) & 0x03;   /* 0 = 2.5, 1 = reserved, 2 = 2, 3 = 1 */
+    bitrate = (p[2] >> 4) & 0x0F;
+    rate = (p[2] >> 2) & 0x03;
+    padding = (p[2] >> 1) & 0x01;
+
+    /* layer 3 only, no free format */
+    if ((version == 1) || (((p[1] >> 1) & 0x03) != 1) || (bitrate == 0) ||
+        (bitrate == 15) || (rate == 3))
+    {
+        return -1;
+    }
+
+    mpeg1 = (version == 3);
+    frame->samplerate = samplerate_tab[rate] >> (mpeg1 ? 0 : ((version == 2) ? 1 : 2));
+    frame->channels = (((p[3] >> 6) & 0x03) == 3) ? 1 : 2;
+    frame->samples = mpeg1 ? 1152 : 576;
+    frame->size = ((mpeg1 ? 144 : 72) * 1000 * bitrate_tab[mpeg1 ? 0 : 1][bitrate]) /
+                  frame->samplerate + padding;
+
+    return 0;
+}
+
+/**
+ * @brief Checks if SYNC_FRAMES frames follow each other at pos
+ */
+static int _is_sync(const unsigned char *data, uint32_t pos, uint32_t end)
+{
+    frame_t frame, first;
+    int i;
+
+    for (i = 0; i < SYNC_FRAMES; i++)
+    {
+        if (((end - pos) < 4) || (_parse_header(&data[pos], &frame) != 0))
+        {
+            return 0;
+        }
+
+        if (i == 0)
+        {
+            first = frame;
+        }
+        else if ((frame.samplerate != first.samplerate) || (frame.channels != first.channels))
+        {
+            return 0;
+        }
+
+        pos += frame.size;
+
+        if (pos > end)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Reads a whole file into memory
+ */
+static unsigned char *_read_file(const char *path, uint32_t *size)
+{
+    FILE *f;
+    long len;
+    unsigned char *data = NULL;
+
+    if ((f = fopen(path, "rb")) == NULL)
+    {
+        return NULL;
+    }
+
+    if ((fseek(f, 0, SEEK_END) == 0) && ((len = ftell(f)) > 0) && (len < AT25DF641_MEM_SIZE) &&
+        (fseek(f, 0, SEEK_SET) == 0) && ((data = malloc(len)) != NULL))
+    {
+        if (fread(data, 1, len, f) != (size_t)len)
+        {
+            free(data);
+            data = NULL;
+        }
+
+        *size = (uint32_t)len;
+    }
+
+    fclose(f);
+
+    return data;
+}
+
+/** Reads little endian values of the WAV header */
+#define LE16(p)         ((uint16_t)((p)[0] | ((p)[1] << 8)))
+#define LE32(p)         ((uint32_t)LE16(p) | ((uint32_t)LE16((p) + 2) << 16))
+
+/**
+ * @brief Finds fmt and data chunk of a WAV file and builds the new header
+ */
+static int _parse_wav(track_t *t, uint32_t size)
+{
+    const unsigned char *fmt = NULL;
+    uint32_t fmt_size = 0;
+    uint32_t pos, len, block;
+    uint16_t tag, bits;
+
+    for (pos = 12; (pos + 8) <= size; pos += 8 + ((len + 1) & ~1u))
+    {
+        len = LE32(&t->data[pos + 4]);
+
+        if (len > (size - pos - 8))
+        {
+            len = size - pos - 8;
+        }
+
+        if (memcmp(&t->data[pos], "fmt ", 4) == 0)
+        {
+            fmt = &t->data[pos + 8];
+            fmt_size = len;
+        }
+        else if ((memcmp(&t->data[pos], "data", 4) == 0) && (fmt != NULL))
+        {
+            t->start = pos + 8;
+            t->length = len;
+            break;
+        }
+    }
+
+    if ((fmt == NULL) || (fmt_size < 16) || (fmt_size > WAV_FMT_MAX) || (t->start == 0))
+    {
+        fprintf(stderr, "%s: no fmt or data chunk found\n", t->path);
+        return -1;
+    }
+
+    tag = LE16(&fmt[0]);
+    bits = LE16(&fmt[14]);
+    block = LE16(&fmt[12]);
+    t->first.channels = LE16(&fmt[2]);
+    t->first.samplerate = (int)LE32(&fmt[4]);
+
+    if ((t->first.channels < 1) || (t->first.channels > 2))
+    {
+        fprintf(stderr, "%s: only mono and stereo\n", t->path);
+        return -1;
+    }
+
+    if ((tag == 0x0001) && (bits == 16))
+    {
+        t->format = TRACKDIR_FMT_PCM16;
+    }
+    else if ((tag == 0x0011) && (bits == 4) && (block <= TRACKDIR_ADPCM_BLOCK_MAX) &&
+             (block > (4u * t->first.channels)) && ((block % (4u * t->first.channels)) == 0))
+    {
+        t->format = TRACKDIR_FMT_ADPCM;
+    }
+    else
+    {
+        fprintf(stderr, "%s: only 16 bit PCM and IMA-ADPCM blocks up to %d bytes\n", t->path,
+                TRACKDIR_ADPCM_BLOCK_MAX);
+        return -1;
+    }
+
+    if (t->first.samplerate != 44100)
+    {
+        fprintf(stderr, "%s: %d Hz is played at 44100 Hz\n", t->path, t->first.samplerate);
+    }
+
+    /* RIFF header, the fmt chunk as it is and the data chunk header */
+    memcpy(&t->wav[0], "RIFF", 4);
+    memcpy(&t->wav[8], "WAVE", 4);
+    memcpy(&t->wav[12], "fmt ", 4);
+    memcpy(&t->wav[16], &fmt_size, 4);
+    memcpy(&t->wav[20], fmt, fmt_size);
+    pos = 20 + ((fmt_size + 1) & ~1u);
+    memcpy(&t->wav[pos], "data", 4);
+    memcpy(&t->wav[pos + 4], &t->length, 4);
+    t->wav_size = pos + 8;
+    len = t->wav_size - 8 + t->length;
+    memcpy(&t->wav[4], &len, 4);
+
+    return 0;
+}
+
+/**
+ * @brief Strips the tags and collects the frames of one file
+ */
+static int _parse_track(track_t *t)
+{
+    uint32_t size, pos, end;
+    frame_t frame;
+
+    if ((t->data = _read_file(t->path, &size)) == NULL)
+    {
+        fprintf(stderr, "%s: cannot read\n", t->path);
+        return -1;
+    }
+
+    if ((size >= 12) && (memcmp(t->data, "RIFF", 4) == 0) && (memcmp(&t->data[8], "WAVE", 4) == 0))
+    {
+        return _parse_wav(t, size);
+    }
+
+    t->format = TRACKDIR_FMT_MP3;
+    pos = 0;
+    end = size;
+
+    /* ID3v2 at the start, syncsafe size plus optional footer */
+    if ((size >= 10) && (memcmp(t->data, "ID3", 3) == 0))
+    {
+        pos = 10 + (((uint32_t)(t->data[6] & 0x7F) << 21) | ((t->data[7] & 0x7F) << 14) |
+                    ((t->data[8] & 0x7F) << 7) | (t->data[9] & 0x7F));
+        pos += (t->data[5] & 0x10) ? 10 : 0;
+    }
+
+    /* ID3v1 at the end */
+    if ((end >= (pos + 128)) && (memcmp(&t->data[end - 128], "TAG", 3) == 0))
+    {
+        end -= 128;
+    }
+
+    /* skip junk before the first frame */
+    while ((pos < end) && !_is_sync(t->data, pos, end))
+    {
+        pos++;
+    }
+
+    if ((pos >= end) || (_parse_header(&t->data[pos], &t->first) != 0))
+    {
+        fprintf(stderr, "%s: no mp3 frames found\n", t->path);
+        return -1;
+    }
+
+    if ((t->sizes = malloc(((end - pos) / 24 + 1) * sizeof(uint16_t))) == NULL)
+    {
+        return -1;
+    }
+
+    /* take frames til the first broken or truncated one */
+    t->start = pos;
+    while (((end - pos) >= 4) && (_parse_header(&t->data[pos], &frame) == 0) &&
+           (frame.samplerate == t->first.samplerate) && (frame.channels == t->first.channels) &&
+           (frame.size <= (int)(end - pos)))
+    {
+        t->sizes[t->frames++] = (uint16_t)frame.size;
+        pos += frame.size;
+    }
+
+    t->length = pos - t->start;
+
+    if ((end - pos) > 0)
+    {
+        fprintf(stderr, "%s: %u bytes after the last frame dropped\n", t->path, end - pos);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Parser thread, takes files from the queue til it is empty
+ */
+static void *_worker(void *arg)
+{
+    int n;
+
+    (void)arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&queue_lock);
+        n = next_track++;
+        pthread_mutex_unlock(&queue_lock);
+
+        if (n >= track_count)
+        {
+            return NULL;
+        }
+
+        tracks[n].status = _parse_track(&tracks[n]);
+    }
+}
+
+/**
+ * @brief Writes the seek index of a track into the image
+ *
+ * @return size of the index in bytes
+ */
+static uint32_t _write_index(unsigned char *image, uint32_t addr, const track_t *t)
+{
+    seekidx_hdr_t hdr;
+    seekidx_group_t group;
+    uint32_t offset = 0;
+    uint32_t groups = (t->frames + SEEKIDX_GROUP - 1) / SEEKIDX_GROUP;
+    uint32_t g, i, frame;
+
+    memset(&hdr, 0, sizeof hdr);
+    hdr.magic = SEEKIDX_MAGIC;
+    hdr.frames = t->frames;
+    hdr.frame_samples = (uint16_t)t->first.samples;
+    hdr.samplerate = (uint32_t)t->first.samplerate;
+    memcpy(&image[addr], &hdr, sizeof hdr);
+
+    for (g = 0; g < groups; g++)
+    {
+        memset(&group, 0, sizeof group);
+        group.base = offset;
+
+        for (i = 0; i < SEEKIDX_GROUP; i++)
+        {
+            frame = g * SEEKIDX_GROUP + i;
+
+            if (frame >= t->frames)
+            {
+                break;
+            }
+
+            if (i < (SEEKIDX_GROUP - 1))
+            {
+                group.delta[i] = t->sizes[frame];
+            }
+
+            offset += t->sizes[frame];
+        }
+
+        memcpy(&image[addr + sizeof hdr + g * sizeof group], &group, sizeof group);
+    }
+
+    return sizeof hdr + groups * sizeof group;
+}
+
+/**
+ * @brief Places all tracks and writes directory and image file
+ */
+static int _build_image(const char *out)
+{
+    static trackdir_t dir;
+    unsigned char *image;
+    uint32_t addr = 0;
+    uint32_t index_size;
+    FILE *f;
+    int i;
+
+    if ((image = malloc(AT25DF641_MEM_SIZE)) == NULL)
+    {
+        return -1;
+    }
+
+    memset(image, 0xFF, AT25DF641_MEM_SIZE);
+    memset(&dir, 0, sizeof dir);
+    dir.magic = TRACKDIR_MAGIC;
+    dir.version = TRACKDIR_VERSION;
+    dir.count = (uint16_t)track_count;
+
+    for (i = 0; i < track_count; i++)
+    {
+        const track_t *t = &tracks[i];
+        trackdir_entry_t *e = &dir.entry[i];
+        uint32_t index_addr = ALIGN_UP(addr + t->length, INDEX_ALIGN);
+
+        index_size = sizeof(seekidx_hdr_t) +
+                     ((t->frames + SEEKIDX_GROUP - 1) / SEEKIDX_GROUP) * sizeof(seekidx_group_t);
+
+        if (t->format != TRACKDIR_FMT_MP3)
+        {
+            if ((addr + t->wav_size + t->length) > TRACKDIR_ADDR)
+            {
+                fprintf(stderr, "%s: does not fit, %u bytes free\n", t->path, TRACKDIR_ADDR - addr);
+                free(image);
+                return -1;
+            }
+
+            memcpy(&image[addr], t->wav, t->wav_size);
+            memcpy(&image[addr + t->wav_size], &t->data[t->start], t->length);
+
+            e->offset = addr;
+            e->length = t->wav_size + t->length;
+            e->first_frame = t->wav_size;
+            e->samplerate = (uint32_t)t->first.samplerate;
+            e->channels = (uint8_t)t->first.channels;
+            e->format = (uint8_t)t->format;
+            e->flags = 0;
+            e->index = 0;
+
+            printf("%2d: 0x%06X %8u bytes %-13s %5d Hz %d ch  %s\n", i + 1, addr, e->length,
+                   (t->format == TRACKDIR_FMT_PCM16) ? "pcm16" : "ima-adpcm",
+                   t->first.samplerate, t->first.channels, t->path);
+
+            addr = ALIGN_UP(addr + e->length, TRACK_ALIGN);
+            continue;
+        }
+
+        if ((index_addr + index_size) > TRACKDIR_ADDR)
+        {
+            fprintf(stderr, "%s: does not fit, %u bytes free\n", t->path, TRACKDIR_ADDR - addr);
+            free(image);
+            return -1;
+        }
+
+        memcpy(&image[addr], &t->data[t->start], t->length);
+        _write_index(image, index_addr, t);
+
+        e->offset = addr;
+        e->length = t->length;
+        e->first_frame = 0;
+        e->samplerate = (uint32_t)t->first.samplerate;
+        e->channels = (uint8_t)t->first.channels;
+        e->format = TRACKDIR_FMT_MP3;
+        e->flags = ((pcm_tracks >> i) & 1) ? TRACKDIR_FLAG_PCMCACHE : 0;
+        e->index = index_addr;
+
+        printf("%2d: 0x%06X %8u bytes %6u frames %5d Hz %d ch  %s\n", i + 1, addr, t->length,
+               t->frames, t->first.samplerate, t->first.channels, t->path);
+
+        addr = ALIGN_UP(index_addr + index_size, TRACK_ALIGN);
+    }
+
+    dir.checksum = trackdir_checksum(&dir);
+
+    /* same check as the firmware does */
+    if (trackdir_check(&dir) != OK)
+    {
+        fprintf(stderr, "invalid directory\n");
+        free(image);
+        return -1;
+    }
+
+    memcpy(&image[TRACKDIR_ADDR], &dir, sizeof dir);
+
+    if (((f = fopen(out, "wb")) == NULL) ||
+        (fwrite(image, 1, AT25DF641_MEM_SIZE, f) != AT25DF641_MEM_SIZE))
+    {
+        fprintf(stderr, "%s: cannot write\n", out);
+        free(image);
+        return -1;
+    }
+
+    fclose(f);
+    free(image);
+    printf("%u of %u bytes used\n", addr, TRACKDIR_ADDR);
+
+    return 0;
+}
+
+/**
+ * @brief Marks the tracks of a list like "1,3" for the PCM cache
+ */
+static void _parse_tracks(const char *list)
+{
+    char *end;
+    long n;
+
+    while (*list != '\0')
+    {
+        n = strtol(list, &end, 10);
+
+        if ((end != list) && (n >= 1) && (n <= TRACKDIR_MAX))
+        {
+            pcm_tracks |= 1u << (n - 1);
+        }
+
+        list = (*end == ',') ? (end + 1) : ((end != list) ? end : (list + 1));
+    }
+}
+
+static void _usage(void)
+{
+    fprintf(stderr, "usage: mkflash [-j threads] [-c 1,2,...] -o image.bin track1.mp3 [track2.wav ...]\n");
+}
+
+int main(int argc, char **argv)
+{
+    pthread_t *threads;
+    const char *out = NULL;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    uint16_t endian = 1;
+    int opt, i;
+
+    /* the image holds the structs as they are in memory */
+    if ((sizeof(trackdir_entry_t) != 24) || (sizeof(seekidx_hdr_t) != 16) ||
+        (sizeof(seekidx_group_t) != 36) || (*(uint8_t *)&endian != 1))
+    {
+        fprintf(stderr, "unsupported host\n");
+        return 1;
+    }
+
+    while ((opt = getopt(argc, argv, "j:c:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'j': jobs = atol(optarg); break;
+            case 'c': _parse_tracks(optarg); break;
+            case 'o': out = optarg; break;
+            default: _usage(); return 1;
+        }
+    }
+
+    track_count = argc - optind;
+
+    if ((out == NULL) || (track_count < 1))
+    {
+        _usage();
+        return 1;
+    }
+
+    if (track_count > TRACKDIR_MAX)
+    {
+        fprintf(stderr, "at most %d tracks\n", TRACKDIR_MAX);
+        return 1;
+    }
+
+    if (jobs < 1)
+    {
+        jobs = 1;
+    }
+
+    if (jobs > track_count)
+    {
+        jobs = track_count;
+    }
+
+    tracks = calloc(track_count, sizeof(track_t));
+    threads = calloc(jobs, sizeof(pthread_t));
+
+    if ((tracks == NULL) || (threads == NULL))
+    {
+        return 1;
+    }
+
+    for (i = 0; i < track_count; i++)
+    {
+        tracks[i].path = argv[optind + i];
+    }
+
+    for (i = 0; i < jobs; i++)
+    {
+        if (pthread_create(&threads[i], NULL, _worker, NULL) != 0)
+        {
+            jobs = i;
+            break;
+        }
+    }
+
+    /* the main thread helps, so there is progress even without threads */
+    _worker(NULL);
+
+    for (i = 0; i < jobs; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < track_count; i++)
+    {
+        if (tracks[i].status != 0)
+        {
+            return 1;
+        }
+    }
+
+    return (_build_image(out) == 0) ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+/**
+ * @{
+ *
+ * @brief     Host tool which sends an MP3 file as live stream over the UART
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Build on a Linux host, from the repository root:
+ *   gcc -O2 -o mp3send tools/mp3send/mp3send.c
+ *
+ * Usage:
+ *   mp3send [-j jitter_ms] [-r permille] [-s seed] tty track.mp3
+ *
+ * Sends every frame at the time it is due for playback, like a live
+ * source. -j holds every frame back by a random time up to jitter_ms, -r
+ * runs the clock of the sender faster or slower (default 1000). Bytes
+ * between the frames are sent without delay. The tty is USART3 of the
+ * board or the pty printed by tools/at25emu/at25stream.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+
+/** Bitrates in kbit/s of layer 3, MPEG-1 and MPEG-2/2.5 */
+static const int bitrate_tab[2][16] = {
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}
+};
+
+/** Sample rates in Hz of MPEG-1 */
+static const int samplerate_tab[4] = {44100, 48000, 32000, 0};
+
+/**
+ * @brief Parses a layer 3 frame header
+ *
+ * @param[out] *ns      playback time of the frame
+ *
+ * @return size of the frame, 0 if p holds no valid header
+ */
+static int _parse_header(const unsigned char *p, uint64_t *ns)
+{
+    int version, index, rate, mpeg1;
+
+    if ((p[0] != 0xFF) || ((p[1] & 0xE0) != 0xE0))
+    {
+        return 0;
+    }
+
+    version = (p[1] >> 3) & 0x03;
+    index = (p[2] >> 4) & 0x0F;
+    rate = (p[2] >> 2) & 0x03;
+
+    if ((version == 1) || (((p[1] >> 1) & 0x03) != 1) || (index == 0) || (index == 15) ||
+        (rate == 3))
+    {
+        return 0;
+    }
+
+    mpeg1 = (version == 3);
+    rate = samplerate_tab[rate] >> (mpeg1 ? 0 : ((version == 2) ? 1 : 2));
+    *ns = ((mpeg1 ? 1152ULL : 576ULL) * 1000000000ULL) / rate;
+
+    return ((mpeg1 ? 144 : 72) * 1000 * bitrate_tab[mpeg1 ? 0 : 1][index]) / rate +
+           ((p[2] >> 1) & 0x01);
+}
+
+static uint64_t _now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static void _sleep_until(uint64_t ns)
+{
+    uint64_t now = _now();
+    struct timespec ts;
+
+    if (ns > now)
+    {
+        ts.tv_sec = (ns - now) / 1000000000ULL;
+        ts.tv_nsec = (ns - now) % 1000000000ULL;
+        nanosleep(&ts, NULL);
+    }
+}
+
+static int _write(int fd, const unsigned char *buf, uint32_t len)
+{
+    ssize_t n;
+
+    while (len > 0)
+    {
+        if ((n = write(fd, buf, len)) <= 0)
+        {
+            return -1;
+        }
+
+        buf += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    struct termios tio;
+    unsigned char *data;
+    uint64_t due, frame_ns = 0, jitter_ns = 0;
+    uint32_t len, pos = 0, frames = 0;
+    int permille = 1000;
+    int fd, opt, size;
+    FILE *fp;
+
+    while ((opt = getopt(argc, argv, "j:r:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'j':
+                jitter_ns = strtoull(optarg, NULL, 0) * 1000000ULL;
+                break;
+            case 'r':
+                permille = atoi(optarg);
+                break;
+            case 's':
+                srand(atoi(optarg));
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+
+    if (((argc - optind) != 2) || (permille <= 0))
+    {
+        fprintf(stderr, "usage: %s [-j jitter_ms] [-r permille] [-s seed] tty track.mp3\n",
+                argv[0]);
+        return 1;
+    }
+
+    if ((fp = fopen(argv[optind + 1], "rb")) == NULL)
+    {
+        fprintf(stderr, "can not open %s\n", argv[optind + 1]);
+        return 1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if ((len < 4) || ((data = malloc(len)) == NULL) || (fread(data, 1, len, fp) != len))
+    {
+        fprintf(stderr, "can not read %s\n", argv[optind + 1]);
+        return 1;
+    }
+
+    fclose(fp);
+
+    if ((fd = open(argv[optind], O_RDWR | O_NOCTTY)) < 0)
+    {
+        fprintf(stderr, "can not open %s\n", argv[optind]);
+        return 1;
+    }
+
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B921600);
+    cfsetospeed(&tio, B921600);
+    tcsetattr(fd, TCSANOW, &tio);
+
+    due = _now();
+
+    while (pos < len)
+    {
+        size = ((pos + 4) <= len) ? _parse_header(&data[pos], &frame_ns) : 0;
+
+        /* tags and junk go out at once */
+        if ((size == 0) || ((pos + size) > len))
+        {
+            size = 1;
+            frame_ns = 0;
+        }
+        else
+        {
+            _sleep_until(due + ((jitter_ns > 0) ? ((uint64_t)rand() % jitter_ns) : 0));
+            due += (frame_ns * 1000) / permille;
+            frames++;
+        }
+
+        if (_write(fd, &data[pos], size) != 0)
+        {
+            fprintf(stderr, "can not write %s\n", argv[optind]);
+            return 1;
+        }
+
+        pos += size;
+    }
+
+    tcdrain(fd);
+    printf("%u frames, %u bytes\n", frames, len);
+
+    free(data);
+    close(fd);
+
+    return 0;
+}
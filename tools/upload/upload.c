@@ -0,0 +1,313 @@
+/**
+ * @{
+ *
+ * @brief     Host tool which uploads a flash image over the UART during playback
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * Build on a Linux host, from the repository root:
+ *   gcc -O2 -I. -o upload tools/upload/upload.c
+ *
+ * Usage:
+ *   upload [-a addr] [-c] tty image.bin
+ *
+ * Writes image.bin to the work chip at addr (default 0, 64KB aligned) with
+ * the protocol of include/ingest.h and checks the CRC of the board. With -c
+ * the upload is committed afterwards, the board copies it to the orig chip
+ * and plays the new directory. The tty is USART6 of the board or the pty
+ * printed by tools/at25emu/at25ingest.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+
+#include "include/ingest.h"
+
+/** Seconds to wait for a reply of the board */
+#define REPLY_TIMEOUT   (30)
+
+/**
+ * @brief CRC like the STM32 CRC unit, little endian words, tail padded with zeros
+ */
+static uint32_t _crc(const unsigned char *data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    uint32_t word, i;
+    int bit;
+
+    for (i = 0; i < len; i += 4)
+    {
+        word = data[i];
+        word |= ((i + 1) < len) ? ((uint32_t)data[i + 1] << 8) : 0;
+        word |= ((i + 2) < len) ? ((uint32_t)data[i + 2] << 16) : 0;
+        word |= ((i + 3) < len) ? ((uint32_t)data[i + 3] << 24) : 0;
+
+        crc ^= word;
+
+        for (bit = 0; bit < 32; bit++)
+        {
+            crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static double _now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+/**
+ * @brief Reads exactly len bytes, fails after REPLY_TIMEOUT
+ */
+static int _read(int fd, unsigned char *buf, int len)
+{
+    double end = _now() + REPLY_TIMEOUT;
+    ssize_t n;
+
+    while (len > 0)
+    {
+        if (_now() > end)
+        {
+            return -1;
+        }
+
+        n = read(fd, buf, len);
+
+        if (n > 0)
+        {
+            buf += n;
+            len -= n;
+        }
+    }
+
+    return 0;
+}
+
+static int _write(int fd, const unsigned char *buf, int len)
+{
+    ssize_t n;
+
+    while (len > 0)
+    {
+        if ((n = write(fd, buf, len)) <= 0)
+        {
+            return -1;
+        }
+
+        buf += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+static void _put32(unsigned char *p, uint32_t value)
+{
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+/**
+ * @brief Waits for the final reply, counts credits which come in before
+ *
+ * @return              0 on INGEST_REPLY_OK, the status or -1 otherwise
+ */
+static int _reply(int fd, uint32_t *value, uint32_t *credits)
+{
+    unsigned char c, buf[4];
+
+    for (;;)
+    {
+        if (_read(fd, &c, 1) != 0)
+        {
+            fprintf(stderr, "no reply\n");
+            return -1;
+        }
+
+        if (c == INGEST_REPLY_CREDIT)
+        {
+            if (credits != NULL)
+            {
+                (*credits)++;
+                return 1;
+            }
+        }
+        else if (c == INGEST_REPLY_OK)
+        {
+            if (_read(fd, buf, 4) != 0)
+            {
+                return -1;
+            }
+
+            *value = buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+            return 0;
+        }
+        else if (c == INGEST_REPLY_ERROR)
+        {
+            if (_read(fd, buf, 1) != 0)
+            {
+                return -1;
+            }
+
+            fprintf(stderr, "board error %d\n", (int8_t)buf[0]);
+            return ((int8_t)buf[0] != 0) ? (int8_t)buf[0] : -1;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    struct termios tio;
+    unsigned char *data, cmd[9];
+    uint32_t addr = 0, len, sent = 0, credits = 0, crc, n;
+    double start;
+    int commit = 0;
+    int fd, opt, ret;
+    FILE *fp;
+
+    while ((opt = getopt(argc, argv, "a:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'a':
+                addr = strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                commit = 1;
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+
+    if ((argc - optind) != 2)
+    {
+        fprintf(stderr, "usage: %s [-a addr] [-c] tty image.bin\n", argv[0]);
+        return 1;
+    }
+
+    if ((fp = fopen(argv[optind + 1], "rb")) == NULL)
+    {
+        fprintf(stderr, "can not open %s\n", argv[optind + 1]);
+        return 1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if ((len == 0) || ((data = malloc(len)) == NULL) || (fread(data, 1, len, fp) != len))
+    {
+        fprintf(stderr, "can not read %s\n", argv[optind + 1]);
+        return 1;
+    }
+
+    fclose(fp);
+
+    if ((fd = open(argv[optind], O_RDWR | O_NOCTTY)) < 0)
+    {
+        fprintf(stderr, "can not open %s\n", argv[optind]);
+        return 1;
+    }
+
+    /* raw 8N1, reads return after 100ms without data */
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B921600);
+    cfsetospeed(&tio, B921600);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 1;
+    tcsetattr(fd, TCSANOW, &tio);
+    tcflush(fd, TCIOFLUSH);
+
+    cmd[0] = INGEST_CMD_WRITE;
+    _put32(&cmd[1], addr);
+    _put32(&cmd[5], len);
+    start = _now();
+
+    if (_write(fd, cmd, 9) != 0)
+    {
+        fprintf(stderr, "can not write %s\n", argv[optind]);
+        return 1;
+    }
+
+    /* every credit is room for one chunk */
+    while (sent < len)
+    {
+        if (credits == 0)
+        {
+            if ((ret = _reply(fd, &crc, &credits)) != 1)
+            {
+                return 1;
+            }
+        }
+
+        n = len - sent;
+        n = (n < INGEST_CHUNK) ? n : INGEST_CHUNK;
+
+        if (_write(fd, &data[sent], n) != 0)
+        {
+            return 1;
+        }
+
+        sent += n;
+        credits--;
+        printf("\r%u / %u KB", sent / 1024, len / 1024);
+        fflush(stdout);
+    }
+
+    /* credits for chunks which are not needed any more are dropped */
+    do
+    {
+        ret = _reply(fd, &crc, &credits);
+    } while (ret == 1);
+
+    if (ret != 0)
+    {
+        return 1;
+    }
+
+    printf("\n%u bytes in %.2f s, %.1f KB/s\n", len, _now() - start, len / 1024.0 / (_now() - start));
+
+    if (crc != _crc(data, len))
+    {
+        fprintf(stderr, "CRC mismatch: board 0x%08X, file 0x%08X\n", crc, _crc(data, len));
+        return 1;
+    }
+
+    printf("CRC 0x%08X ok\n", crc);
+
+    if (commit)
+    {
+        cmd[0] = INGEST_CMD_COMMIT;
+        start = _now();
+
+        if ((_write(fd, cmd, 1) != 0) || (_reply(fd, &crc, NULL) != 0))
+        {
+            return 1;
+        }
+
+        printf("committed in %.2f s\n", _now() - start);
+    }
+
+    free(data);
+    close(fd);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @{
+ *
+ * @brief     Track directory stored on the serial flash
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "include/trackdir.h"
+#include "driver/define/at25df641_def.h"
+
+/** Size of one track of the old flash images */
+#define LEGACY_TRACK_SIZE   (0x200000)
+
+int trackdir_check(const trackdir_t *dir)
+{
+    const trackdir_entry_t *e;
+    int i;
+
+    if ((dir->magic != TRACKDIR_MAGIC) || (dir->version != TRACKDIR_VERSION))
+    {
+        return ERROR_ID;
+    }
+
+    if (dir->count > TRACKDIR_MAX)
+    {
+        return ERROR_OUT_OF_BOUND;
+    }
+
+    if (dir->checksum != trackdir_checksum(dir))
+    {
+        return ERROR_DEFAULT;
+    }
+
+    for (i = 0; i < dir->count; i++)
+    {
+        e = &dir->entry[i];
+
+        /* tracks must not overlap the directory block */
+        if ((e->offset >= TRACKDIR_ADDR) || (e->length > (TRACKDIR_ADDR - e->offset)) ||
+            (e->first_frame >= e->length))
+        {
+            return ERROR_OUT_OF_BOUND;
+        }
+    }
+
+    return OK;
+}
+
+const trackdir_entry_t *trackdir_get(const trackdir_t *dir, int n)
+{
+    if ((n < 0) || (n >= dir->count))
+    {
+        return NULL;
+    }
+
+    return &dir->entry[n];
+}
+
+void trackdir_legacy(trackdir_t *dir)
+{
+    int i;
+
+    memset(dir, 0, sizeof(trackdir_t));
+    dir->magic = TRACKDIR_MAGIC;
+    dir->version = TRACKDIR_VERSION;
+    dir->count = 2;
+
+    for (i = 0; i < dir->count; i++)
+    {
+        dir->entry[i].offset = i * LEGACY_TRACK_SIZE;
+        dir->entry[i].length = LEGACY_TRACK_SIZE;
+        dir->entry[i].samplerate = 44100;
+        dir->entry[i].channels = 2;
+        dir->entry[i].format = TRACKDIR_FMT_MP3;
+    }
+
+    dir->checksum = trackdir_checksum(dir);
+}
@@ -0,0 +1,216 @@
+/**
+ * @{
+ *
+ * @brief     Low-level peripheral driver for UART.
+ * @author    Copyright (C) René Herthel <rene-herthel@outlook.de>
+ * @author    Copyright (C) Hauke Sondermann <hauke.sondermann@haw-hamburg.de>
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stm32f4xx.h>
+
+#include "driver/uart.h"
+#include "driver/gpio.h"
+
+/** Shifts to the channel select bits in the DMA stream CR register */
+#define DMA_SxCR_CHSEL_SHIFT (25)
+
+/** Size of the receive rings */
+static uint16_t rx_len[UART_NUMOF];
+
+int uart_init(uart_t dev, uint32_t baud)
+{
+    USART_TypeDef *uart;
+    GPIO_TypeDef *port;
+    uint32_t clk;
+    int pin[2], af, hl, i;
+
+    switch (dev)
+    {
+#if UART_0_EN
+        case UART_0:
+            uart = UART_0_DEV;
+            clk = UART_0_CLK;
+            port = UART_0_PORT;
+            pin[0] = UART_0_TX_PIN;
+            pin[1] = UART_0_RX_PIN;
+            af = UART_0_AF;
+            UART_0_CLKEN();
+            UART_0_PORT_CLKEN();
+            UART_0_DMA_CLKEN();
+            break;
+#endif /* UART_0_EN */
+#if UART_1_EN
+        case UART_1:
+            uart = UART_1_DEV;
+            clk = UART_1_CLK;
+            port = UART_1_PORT;
+            pin[0] = UART_1_TX_PIN;
+            pin[1] = UART_1_RX_PIN;
+            af = UART_1_AF;
+            UART_1_CLKEN();
+            UART_1_PORT_CLKEN();
+            UART_1_DMA_CLKEN();
+            break;
+#endif /* UART_1_EN */
+        default:
+            return -1;
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        /* Set GPIOs to AF mode */
+        port->MODER &= ~(3 << (2 * pin[i]));
+        port->MODER |= (GPIO_MODE_AF << (2 * pin[i]));
+        /* Set speed */
+        port->OSPEEDR &= ~(3 << (2 * pin[i]));
+        port->OSPEEDR |= (GPIO_SPEED_HIGH << (2 * pin[i]));
+        /* Set to push-pull configuration */
+        port->OTYPER &= ~(GPIO_OT_OPENDRAIN << pin[i]);
+        /* Pull-up, the idle level of the line */
+        port->PUPDR &= ~(3 << (2 * pin[i]));
+        port->PUPDR |= (GPIO_PULLUP << (2 * pin[i]));
+        /* Configure GPIOs for the UART alternate function */
+        hl = (pin[i] < 8) ? 0 : 1;
+        port->AFR[hl] &= ~(0xf << ((pin[i] - (hl * 8)) * 4));
+        port->AFR[hl] |= (af << ((pin[i] - (hl * 8)) * 4));
+    }
+
+    /* 16 times oversampling, BRR holds the rounded divider */
+    uart->CR1 = 0;
+    uart->CR2 = 0;
+    uart->CR3 = 0;
+    uart->BRR = (clk + (baud / 2)) / baud;
+    uart->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+
+    return 0;
+}
+
+void uart_write(uart_t dev, const unsigned char *data, int len)
+{
+    USART_TypeDef *uart;
+    int i;
+
+    switch (dev)
+    {
+#if UART_0_EN
+        case UART_0:
+            uart = UART_0_DEV;
+            break;
+#endif
+#if UART_1_EN
+        case UART_1:
+            uart = UART_1_DEV;
+            break;
+#endif
+        default:
+            return;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        while (!(uart->SR & USART_SR_TXE));
+        uart->DR = data[i];
+    }
+}
+
+int uart_rx_start(uart_t dev, unsigned char *buf, uint16_t len)
+{
+    USART_TypeDef *uart;
+    DMA_Stream_TypeDef *rx;
+    uint32_t chan;
+
+    switch (dev)
+    {
+#if UART_0_EN
+        case UART_0:
+            uart = UART_0_DEV;
+            rx = UART_0_DMA_RX_STREAM;
+            chan = UART_0_DMA_CHAN;
+            uart_rx_stop(dev);
+            UART_0_DMA_RX_IFCR = UART_0_DMA_RX_FLAGS;
+            break;
+#endif
+#if UART_1_EN
+        case UART_1:
+            uart = UART_1_DEV;
+            rx = UART_1_DMA_RX_STREAM;
+            chan = UART_1_DMA_CHAN;
+            uart_rx_stop(dev);
+            UART_1_DMA_RX_IFCR = UART_1_DMA_RX_FLAGS;
+            break;
+#endif
+        default:
+            return -1;
+    }
+
+    if (len == 0)
+    {
+        return -1;
+    }
+
+    rx_len[dev] = len;
+
+    /* peripheral to memory, circular, no interrupts, the reader polls */
+    rx->PAR = (uint32_t) &uart->DR;
+    rx->M0AR = (uint32_t) buf;
+    rx->NDTR = len;
+    rx->FCR = 0;
+    rx->CR = (chan << DMA_SxCR_CHSEL_SHIFT) | DMA_SxCR_PL_1 | DMA_SxCR_MINC | DMA_SxCR_CIRC;
+
+    /* drop an old byte and the overrun flag it may have caused */
+    (void) uart->SR;
+    (void) uart->DR;
+    rx->CR |= DMA_SxCR_EN;
+    uart->CR3 |= USART_CR3_DMAR;
+
+    return 0;
+}
+
+uint16_t uart_rx_pos(uart_t dev)
+{
+    uint16_t left;
+
+    switch (dev)
+    {
+#if UART_0_EN
+        case UART_0:
+            left = UART_0_DMA_RX_STREAM->NDTR;
+            break;
+#endif
+#if UART_1_EN
+        case UART_1:
+            left = UART_1_DMA_RX_STREAM->NDTR;
+            break;
+#endif
+        default:
+            return 0;
+    }
+
+    /* NDTR counts down and reloads with the ring size */
+    return (left == 0) ? 0 : (rx_len[dev] - left);
+}
+
+void uart_rx_stop(uart_t dev)
+{
+    switch (dev)
+    {
+#if UART_0_EN
+        case UART_0:
+            UART_0_DEV->CR3 &= ~USART_CR3_DMAR;
+            UART_0_DMA_RX_STREAM->CR &= ~DMA_SxCR_EN;
+            while (UART_0_DMA_RX_STREAM->CR & DMA_SxCR_EN);
+            break;
+#endif
+#if UART_1_EN
+        case UART_1:
+            UART_1_DEV->CR3 &= ~USART_CR3_DMAR;
+            UART_1_DMA_RX_STREAM->CR &= ~DMA_SxCR_EN;
+            while (UART_1_DMA_RX_STREAM->CR & DMA_SxCR_EN);
+            break;
+#endif
+    }
+}